@@ -40,8 +40,21 @@ SOFTWARE.
 #include <algorithm> // std::shuffle, std::next, std::distance
 #include <iterator> // std::begin, std::end, std::iterator_traits
 #include <limits> // std::numeric_limits
+#include <cmath> // std::nextafter, std::pow, std::fma
+#include <cstring> // std::memcpy
+#include <cstdint>
+#include <stdexcept> // std::invalid_argument
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread> // parallel algorithms
+#include <atomic>
+#include <exception> // std::exception_ptr
 #include <ostream>
 #include <istream>
+#if __cplusplus >= 202002L || ( defined( _MSVC_LANG ) && _MSVC_LANG >= 202002L )
+#include <ranges> // std::ranges::view_base
+#endif
 
 namespace effolkronium {
 
@@ -52,6 +65,9 @@ namespace effolkronium {
         /// Key type for weighted random number generation
         struct weight{ };
 
+        /// Key type for cache-aware bucketed shuffle
+        struct bucketed{ };
+
         /// True if type T is applicable by a std::uniform_int_distribution
         template<typename T>
         struct is_uniform_int {
@@ -157,6 +173,1673 @@ namespace effolkronium {
         template<typename Type>
         struct is_map<Type, void_t<typename Type::key_type, typename Type::mapped_type, typename Type::value_type>> : public std::true_type{};
 
+        /// True if type T stores its elements contiguously behind data()
+        template<typename Type, typename = void>
+        struct is_contiguous : public std::false_type {};
+
+        template<typename Type>
+        struct is_contiguous<Type, void_t<typename Type::value_type,
+            decltype(std::declval<const Type&>().data()),
+            decltype(std::declval<const Type&>().size())>> : public std::true_type{};
+
+        /// Number of lanes processed together by the weight kernels
+        constexpr std::size_t weight_lanes = 8;
+
+        /**
+        * \brief Sum of 'size' weights
+        * \note Accumulates into independent lanes, so the loop
+        *       has no serial dependency and can be vectorized
+        */
+        template<typename T>
+        T weight_sum( const T* weights, std::size_t size ) {
+            T lanes[ weight_lanes ] = { };
+            std::size_t i = 0;
+            for( ; i + weight_lanes <= size; i += weight_lanes )
+                for( std::size_t lane = 0; lane < weight_lanes; ++lane )
+                    lanes[ lane ] += weights[ i + lane ];
+
+            T total = 0;
+            for( std::size_t lane = 0; lane < weight_lanes; ++lane )
+                total += lanes[ lane ];
+            for( ; i < size; ++i )
+                total += weights[ i ];
+            return total;
+        }
+
+        /**
+        * \brief Index of the first weight whose cumulative sum exceeds 'value'
+        * \note Skips whole blocks by their lane sum and only walks
+        *       the block that contains the answer element by element.
+        *       The early exit depends on the data, so only the block sums
+        *       are unrolled, the loop itself is not vectorized
+        * \note If rounding leaves 'value' above the cumulative sum,
+        *       return the last index with a positive weight
+        */
+        template<typename T>
+        std::size_t weight_search( const T* weights, std::size_t size, T value ) {
+            T sum = 0;
+            std::size_t i = 0;
+            for( ; i + weight_lanes <= size; i += weight_lanes ) {
+                T block = 0;
+                for( std::size_t lane = 0; lane < weight_lanes; ++lane )
+                    block += weights[ i + lane ];
+                if( sum + block > value ) break;
+                sum += block;
+            }
+            for( ; i < size; ++i ) {
+                sum += weights[ i ];
+                if( sum > value ) return i;
+            }
+            while( size > 0 && !( weights[ size - 1 ] > T( 0 ) ) )
+                --size;
+            return size - 1;
+        }
+
+        /**
+        * \brief Type of the weights stored in a weighted container:
+        *        mapped_type for map-like containers and
+        *        value_type for contiguous containers
+        * \note Has no 'type' member for any other type
+        */
+        template<typename Type, typename = void>
+        struct weight_type { };
+
+        template<typename Type>
+        struct weight_type<Type, typename std::enable_if<
+            is_map<Type>::value>::type> {
+            using type = typename Type::mapped_type;
+
+            template<typename Iterator>
+            static type get( Iterator it ) { return it->second; }
+        };
+
+        template<typename Type>
+        struct weight_type<Type, typename std::enable_if<
+            !is_map<Type>::value && is_contiguous<Type>::value>::type> {
+            using type = typename Type::value_type;
+
+            template<typename Iterator>
+            static type get( Iterator it ) { return *it; }
+        };
+
+        /// True if type T is applicable as a weight of batched weighted generation
+        template<typename T>
+        struct is_weight {
+            static constexpr bool value =
+                   is_uniform_real<T>::value
+                || ( is_uniform_int<T>::value && std::is_unsigned<T>::value );
+        };
+
+        /**
+        * \brief Return a random real number in a [0; 1) range
+        * \note Some standard libraries can round
+        *       std::generate_canonical up to 1, which is excluded here
+        */
+        template<typename Real, typename Engine>
+        Real canonical( Engine& engine ) {
+            const Real value = std::generate_canonical<Real,
+                std::numeric_limits<Real>::digits>( engine );
+            return value < Real( 1 ) ? value
+                : std::nextafter( Real( 1 ), Real( 0 ) );
+        }
+
+        /**
+        * \brief Write 'count' weighted random iterators of 'container' to 'out'
+        * \note The random thresholds are generated already sorted
+        *       (Bentley & Saxe), so a single pass over the container
+        *       serves all of them: O(count + size) in total
+        * \note Iterators are written in container order
+        */
+        template<typename Engine, typename Container, typename OutputIt>
+        OutputIt weighted_draws( Engine& engine, const Container& container,
+                                 std::size_t count, OutputIt out ) {
+            using Access = weight_type<Container>;
+            using Real = typename std::common_type<
+                typename Access::type, double>::type;
+            using IteratorType = decltype( std::begin( container ) );
+
+            Real total_weight = 0;
+            for( IteratorType it = std::begin( container ); it != std::end( container ); ++it ) {
+                assert( Access::get( it ) >= typename Access::type( 0 ) );
+                total_weight += static_cast<Real>( Access::get( it ) );
+            }
+            if( !( total_weight > Real( 0 ) ) ) return out;
+
+            IteratorType it = std::begin( container );
+            IteratorType last_positive = it;
+            Real sum = static_cast<Real>( Access::get( it ) );
+            Real remaining = 1; // largest of the still undrawn points
+
+            for( std::size_t left = count; left > 0; --left ) {
+                // Max of 'left' uniforms is U^(1/left), so 1 - remaining ascends
+                remaining *= std::pow( Real( 1 ) - canonical<Real>( engine ),
+                                       Real( 1 ) / static_cast<Real>( left ) );
+                const Real threshold = ( Real( 1 ) - remaining ) * total_weight;
+
+                while( it != std::end( container ) && !( sum > threshold ) ) {
+                    if( Access::get( it ) > typename Access::type( 0 ) )
+                        last_positive = it;
+                    if( ++it != std::end( container ) )
+                        sum += static_cast<Real>( Access::get( it ) );
+                }
+                // Rounding could push the threshold past the final sum
+                *out++ = it != std::end( container ) ? it : last_positive;
+            }
+            return out;
+        }
+
+        /**
+        * \brief Emit 'guide_size' guide entries for the cumulative weights:
+        *        entry j is the first index whose cumulative weight
+        *        exceeds j / guide_size of the total
+        * \param cumulative Inclusive prefix sums of the weights
+        * \param last The last index with a positive weight
+        * \param emit Callable invoked with each guide entry in order
+        */
+        template<typename RealType, typename Emit>
+        void guide_build( const RealType* cumulative, std::size_t last,
+                          std::size_t guide_size, Emit emit ) {
+            const RealType total = cumulative[ last ];
+            std::size_t index = 0;
+            for( std::size_t j = 0; j < guide_size; ++j ) {
+                const RealType value = total * static_cast<RealType>( j )
+                    / static_cast<RealType>( guide_size );
+                while( index < last && !( cumulative[ index ] > value ) )
+                    ++index;
+                emit( index );
+            }
+        }
+
+        /**
+        * \brief Return the smallest index whose cumulative weight
+        *        exceeds u * total, starting from the guide entry of u
+        *        and walking back or forward from it
+        * \param u A number in [0; 1) range
+        */
+        template<typename RealType, typename IndexType>
+        std::size_t guide_search( const RealType* cumulative, std::size_t last,
+                                  const IndexType* guide, std::size_t guide_size,
+                                  RealType u ) {
+            const RealType value = u * cumulative[ last ];
+
+            std::size_t guide_index = static_cast<std::size_t>(
+                u * static_cast<RealType>( guide_size ) );
+            if( guide_index >= guide_size )
+                guide_index = guide_size - 1;
+
+            std::size_t index = static_cast<std::size_t>( guide[ guide_index ] );
+            // The guide slot and 'value' are rounded separately from the guide,
+            // so the entry may already be past the answer by an ulp
+            while( index > 0 && cumulative[ index - 1 ] > value )
+                --index;
+            while( index < last && !( cumulative[ index ] > value ) )
+                ++index;
+            return index;
+        }
+
+        /// Number of values staged on the stack by bulk generation
+        constexpr std::size_t bulk_block = 128;
+
+        /**
+        * \brief Number of random bits in each result of 'Engine':
+        *        32 or 64 for engines producing every value of
+        *        their width, 0 for any other engine
+        */
+        template<typename Engine>
+        struct engine_bits {
+            static constexpr int value =
+                  0 != (Engine::min)( ) ? 0
+                : 0xFFFFFFFFull == (Engine::max)( ) ? 32
+                : 0xFFFFFFFFFFFFFFFFull == (Engine::max)( ) ? 64
+                : 0;
+        };
+
+        /// Return 32 random bits from a 32-bit engine
+        template<typename Engine>
+        std::uint32_t next_word( Engine& engine, std::integral_constant<int, 32> ) {
+            return static_cast<std::uint32_t>( engine( ) );
+        }
+
+        /// Return 32 random bits from a 64-bit engine
+        template<typename Engine>
+        std::uint32_t next_word( Engine& engine, std::integral_constant<int, 64> ) {
+            return static_cast<std::uint32_t>( engine( ) >> 32 );
+        }
+
+        /// Return 32 random bits from any other engine
+        template<typename Engine>
+        std::uint32_t next_word( Engine& engine, std::integral_constant<int, 0> ) {
+            return std::uniform_int_distribution<std::uint32_t>{ }( engine );
+        }
+
+        /// Random bits from 'Engine', drawn 32 at a time
+        template<typename Engine>
+        class bit_stream {
+        public:
+            explicit bit_stream( Engine& engine ) : m_engine( engine ) { }
+
+            /// Return next random bit
+            bool operator()( ) {
+                if( 0 == m_left ) {
+                    m_word = next_word( m_engine,
+                        std::integral_constant<int, engine_bits<Engine>::value>{ } );
+                    m_left = 32;
+                }
+                const bool bit = 0 != ( m_word & 1u );
+                m_word >>= 1;
+                --m_left;
+                return bit;
+            }
+        private:
+            Engine& m_engine;
+            std::uint32_t m_word = 0;
+            int m_left = 0;
+        };
+
+        /// Write 'size' words of 32 random bits from a 32-bit engine
+        template<typename Engine>
+        void fill_words( Engine& engine, std::uint32_t* out, std::size_t size,
+                         std::integral_constant<int, 32> ) {
+            for( std::size_t i = 0; i < size; ++i )
+                out[ i ] = static_cast<std::uint32_t>( engine( ) );
+        }
+
+        /// Write 'size' words of 32 random bits from a 64-bit engine
+        template<typename Engine>
+        void fill_words( Engine& engine, std::uint32_t* out, std::size_t size,
+                         std::integral_constant<int, 64> ) {
+            std::size_t i = 0;
+            for( ; i + 2 <= size; i += 2 ) {
+                const std::uint64_t word = engine( );
+                out[ i ] = static_cast<std::uint32_t>( word );
+                out[ i + 1 ] = static_cast<std::uint32_t>( word >> 32 );
+            }
+            if( i < size )
+                out[ i ] = next_word( engine, std::integral_constant<int, 64>{ } );
+        }
+
+        /**
+        * \brief Write 'size' random values in a [from; from + span] range
+        *        to 'out' by multiply-based range reduction (Lemire)
+        * \note Each block of engine words is reduced without branches,
+        *       and only the rare rejected lanes are redrawn in a second pass
+        * \note 'Engine' should have 32 or 64 engine_bits
+        */
+        template<typename T, typename Engine>
+        void bounded_fill( Engine& engine, T* out, std::size_t size,
+                           T from, std::uint32_t span ) {
+            using U = typename std::make_unsigned<T>::type;
+            using bits = std::integral_constant<int, engine_bits<Engine>::value>;
+
+            const std::uint64_t range = std::uint64_t( span ) + 1;
+            // Products with low half under 2^32 mod range would bias the result
+            const std::uint32_t threshold = static_cast<std::uint32_t>(
+                ( std::uint64_t( 1 ) << 32 ) % range );
+
+            std::uint32_t words[ bulk_block ];
+            std::size_t rejected[ bulk_block ];
+            while( size > 0 ) {
+                const std::size_t count = size < bulk_block ? size : bulk_block;
+                fill_words( engine, words, count, bits{ } );
+
+                std::size_t rejected_count = 0;
+                for( std::size_t i = 0; i < count; ++i ) {
+                    const std::uint64_t product = words[ i ] * range;
+                    out[ i ] = static_cast<T>( static_cast<U>( static_cast<U>( from )
+                        + static_cast<U>( product >> 32 ) ) );
+                    rejected[ rejected_count ] = i;
+                    rejected_count += static_cast<std::uint32_t>( product ) < threshold ? 1 : 0;
+                }
+
+                for( std::size_t i = 0; i < rejected_count; ++i ) {
+                    std::uint64_t product;
+                    do {
+                        product = next_word( engine, bits{ } ) * range;
+                    } while( static_cast<std::uint32_t>( product ) < threshold );
+                    out[ rejected[ i ] ] = static_cast<T>( static_cast<U>( static_cast<U>( from )
+                        + static_cast<U>( product >> 32 ) ) );
+                }
+
+                out += count;
+                size -= count;
+            }
+        }
+
+        /// Write 'size' words of 64 random bits from a 32-bit engine
+        template<typename Engine>
+        void fill_words( Engine& engine, std::uint64_t* out, std::size_t size,
+                         std::integral_constant<int, 32> ) {
+            for( std::size_t i = 0; i < size; ++i ) {
+                const std::uint64_t high = static_cast<std::uint32_t>( engine( ) );
+                out[ i ] = high << 32 | static_cast<std::uint32_t>( engine( ) );
+            }
+        }
+
+        /// Write 'size' words of 64 random bits from a 64-bit engine
+        template<typename Engine>
+        void fill_words( Engine& engine, std::uint64_t* out, std::size_t size,
+                         std::integral_constant<int, 64> ) {
+            for( std::size_t i = 0; i < size; ++i )
+                out[ i ] = static_cast<std::uint64_t>( engine( ) );
+        }
+
+        /**
+        * \brief Write 'size' random floats in a [from; from + span) range
+        * \note The top 24 bits of each word are scaled to [0; 1),
+        *       the loop is plain integer to float conversion and
+        *       multiply-add, which vectorizes
+        * \note 'Engine' should have 32 or 64 engine_bits
+        */
+        template<typename Engine>
+        void uniform_fill( Engine& engine, float* out, std::size_t size,
+                           float from, float span ) {
+            using bits = std::integral_constant<int, engine_bits<Engine>::value>;
+            const float scale = span / 16777216.f; // span * 2^-24
+
+            std::uint32_t words[ bulk_block ];
+            while( size > 0 ) {
+                const std::size_t count = size < bulk_block ? size : bulk_block;
+                fill_words( engine, words, count, bits{ } );
+                for( std::size_t i = 0; i < count; ++i )
+                    out[ i ] = from + static_cast<float>(
+                        static_cast<std::int32_t>( words[ i ] >> 8 ) ) * scale;
+                out += count;
+                size -= count;
+            }
+        }
+
+        /**
+        * \brief Write 'size' random doubles in a [from; from + span) range
+        * \note The top 52 bits of each word become the mantissa of a
+        *       double in [1; 2), so no integer conversion is needed and
+        *       the loop is plain bit operations and multiply-add
+        * \note 'Engine' should have 32 or 64 engine_bits
+        */
+        template<typename Engine>
+        void uniform_fill( Engine& engine, double* out, std::size_t size,
+                           double from, double span ) {
+            using bits = std::integral_constant<int, engine_bits<Engine>::value>;
+            static_assert( std::numeric_limits<double>::is_iec559,
+                           "uniform_fill expects IEEE 754 doubles" );
+
+            std::uint64_t words[ bulk_block ];
+            while( size > 0 ) {
+                const std::size_t count = size < bulk_block ? size : bulk_block;
+                fill_words( engine, words, count, bits{ } );
+                for( std::size_t i = 0; i < count; ++i ) {
+                    const std::uint64_t one_to_two = words[ i ] >> 12 | 0x3FF0000000000000ull;
+                    double unit;
+                    std::memcpy( &unit, &one_to_two, sizeof unit );
+                    out[ i ] = from + ( unit - 1. ) * span;
+                }
+                out += count;
+                size -= count;
+            }
+        }
+
+        /// True if type T is a one byte storage: char types or std::byte
+        template<typename T, bool = std::is_enum<T>::value>
+        struct is_byte_storage {
+            static constexpr bool value =
+                   is_byte<T>::value
+                || std::is_same<T, char>::value;
+        };
+
+        template<typename T>
+        struct is_byte_storage<T, true> {
+            static constexpr bool value = std::is_same<
+                typename std::underlying_type<T>::type, unsigned char>::value;
+        };
+
+        /**
+        * \brief Copy raw words of a 32 or 64-bit engine to 'size' bytes of 'out'
+        * \note The bytes of the last word beyond 'size' are dropped
+        */
+        template<typename IntegerDist, typename Engine>
+        void random_bytes( Engine& engine, unsigned char* out, std::size_t size, std::true_type ) {
+            using bits = std::integral_constant<int, engine_bits<Engine>::value>;
+            using word_t = typename std::conditional<64 == bits::value,
+                std::uint64_t, std::uint32_t>::type;
+
+            word_t words[ bulk_block ];
+            while( size > 0 ) {
+                const std::size_t bytes = size < sizeof words ? size : sizeof words;
+                fill_words( engine, words, ( bytes + sizeof( word_t ) - 1 ) / sizeof( word_t ), bits{ } );
+                std::memcpy( out, words, bytes );
+                out += bytes;
+                size -= bytes;
+            }
+        }
+
+        /// Write 'size' random bytes by IntegerDist for engines of any other range
+        template<typename IntegerDist, typename Engine>
+        void random_bytes( Engine& engine, unsigned char* out, std::size_t size, std::false_type ) {
+            IntegerDist dist{ 0, 255 };
+            for( std::size_t i = 0; i < size; ++i )
+                out[ i ] = static_cast<unsigned char>( dist( engine ) );
+        }
+
+        /// Write 'size' random bytes to 'out'
+        template<typename IntegerDist, typename Engine>
+        void random_bytes( Engine& engine, unsigned char* out, std::size_t size ) {
+            random_bytes<IntegerDist>( engine, out, size,
+                std::integral_constant<bool, 0 != engine_bits<Engine>::value>{ } );
+        }
+
+        /// Fill contiguous byte storage in [first, last) range with random bytes
+        template<typename IntegerDist, typename Engine, typename T>
+        void random_bytes( Engine& engine, T* first, T* last ) {
+            random_bytes<IntegerDist>( engine, static_cast<unsigned char*>( static_cast<void*>( first ) ),
+                static_cast<std::size_t>( last - first ) );
+        }
+
+        /// Fill byte storage in [first, last) range with random bytes block by block
+        template<typename IntegerDist, typename Engine, typename ForwardIt>
+        void random_bytes( Engine& engine, ForwardIt first, ForwardIt last ) {
+            using T = typename std::iterator_traits<ForwardIt>::value_type;
+            unsigned char block[ bulk_block ];
+            while( first != last ) {
+                random_bytes<IntegerDist>( engine, block, bulk_block );
+                for( std::size_t i = 0; i < bulk_block && first != last; ++i, ++first )
+                    *first = static_cast<T>( block[ i ] );
+            }
+        }
+
+        /// True if type T can be generated in a [from; to] range
+        template<typename T>
+        struct is_range_type {
+            static constexpr bool value =
+                   is_supported_number   <T>::value
+                || is_supported_character<T>::value;
+        };
+
+        /**
+        * \brief Generator of random values in a [from; to] range which
+        *        builds its distribution once for any number of values
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        */
+        template<
+            typename T,
+            template<typename> class IntegerDist,
+            template<typename> class RealDist,
+            typename = void
+        >
+        class range_generator;
+
+        template<typename T, template<typename> class IntegerDist, template<typename> class RealDist>
+        class range_generator<T, IntegerDist, RealDist,
+            typename std::enable_if<is_uniform_int<T>::value>::type> {
+        public:
+            /// Type of generated values
+            using result_type = T;
+
+            range_generator( T from, T to )
+                : m_dist{ from < to ? from : to, from < to ? to : from }
+                , m_from( from < to ? from : to )
+                , m_span( static_cast<U>( static_cast<U>( from < to ? to : from )
+                                        - static_cast<U>( m_from ) ) ) { }
+
+            template<typename Engine>
+            T operator()( Engine& engine ) {
+                return m_dist( engine );
+            }
+
+            /**
+            * \brief Write 'size' random values to contiguous 'out'
+            * \note Uses bounded_fill kernel for spans up to 2^32 values if
+            *       IntegerDist is std::uniform_int_distribution and
+            *       Engine produces full 32 or 64-bit words
+            */
+            template<typename Engine>
+            void operator()( Engine& engine, T* out, std::size_t size ) {
+                fill( engine, out, size, std::integral_constant<bool,
+                       std::is_same<IntegerDist<T>, std::uniform_int_distribution<T>>::value
+                    && 0 != engine_bits<Engine>::value>{ } );
+            }
+        private:
+            using U = typename std::make_unsigned<T>::type;
+
+            template<typename Engine>
+            void fill( Engine& engine, T* out, std::size_t size, std::true_type ) {
+                if( m_span <= 0xFFFFFFFFu )
+                    bounded_fill( engine, out, size, m_from, static_cast<std::uint32_t>( m_span ) );
+                else
+                    fill( engine, out, size, std::false_type{ } );
+            }
+
+            template<typename Engine>
+            void fill( Engine& engine, T* out, std::size_t size, std::false_type ) {
+                for( std::size_t i = 0; i < size; ++i )
+                    out[ i ] = m_dist( engine );
+            }
+        private:
+            IntegerDist<T> m_dist;
+            T m_from;
+            U m_span;
+        };
+
+        template<typename T, template<typename> class IntegerDist, template<typename> class RealDist>
+        class range_generator<T, IntegerDist, RealDist,
+            typename std::enable_if<is_uniform_real<T>::value>::type> {
+        public:
+            /// Type of generated values
+            using result_type = T;
+
+            range_generator( T from, T to )
+                : m_dist{ from < to ? from : to, from < to ? to : from }
+                , m_from( from < to ? from : to )
+                , m_span( ( from < to ? to : from ) - m_from ) { }
+
+            template<typename Engine>
+            T operator()( Engine& engine ) {
+                return m_dist( engine );
+            }
+
+            /**
+            * \brief Write 'size' random values to contiguous 'out'
+            * \note Uses uniform_fill kernel for float and double if
+            *       RealDist is std::uniform_real_distribution and
+            *       Engine produces full 32 or 64-bit words
+            */
+            template<typename Engine>
+            void operator()( Engine& engine, T* out, std::size_t size ) {
+                fill( engine, out, size, std::integral_constant<bool,
+                       std::is_same<RealDist<T>, std::uniform_real_distribution<T>>::value
+                    && !std::is_same<T, long double>::value
+                    && 0 != engine_bits<Engine>::value>{ } );
+            }
+        private:
+            template<typename Engine>
+            void fill( Engine& engine, T* out, std::size_t size, std::true_type ) {
+                uniform_fill( engine, out, size, m_from, m_span );
+            }
+
+            template<typename Engine>
+            void fill( Engine& engine, T* out, std::size_t size, std::false_type ) {
+                for( std::size_t i = 0; i < size; ++i )
+                    out[ i ] = m_dist( engine );
+            }
+        private:
+            RealDist<T> m_dist;
+            T m_from;
+            T m_span;
+        };
+
+        template<typename T, template<typename> class IntegerDist, template<typename> class RealDist>
+        class range_generator<T, IntegerDist, RealDist,
+            typename std::enable_if<is_byte<T>::value
+                                 || is_supported_character<T>::value>::type> {
+            // Bytes are generated by short and unsigned short, characters by std::int64_t
+            using dist_t = typename std::conditional<is_supported_character<T>::value, std::int64_t,
+                typename std::conditional<std::is_signed<T>::value, short, unsigned short>::type>::type;
+        public:
+            /// Type of generated values
+            using result_type = T;
+
+            range_generator( T from, T to )
+                : m_dist{ static_cast<dist_t>( from < to ? from : to ),
+                          static_cast<dist_t>( from < to ? to : from ) } { }
+
+            template<typename Engine>
+            T operator()( Engine& engine ) {
+                return static_cast<T>( m_dist( engine ) );
+            }
+
+            /// Write 'size' random values to contiguous 'out'
+            template<typename Engine>
+            void operator()( Engine& engine, T* out, std::size_t size ) {
+                for( std::size_t i = 0; i < size; ++i )
+                    out[ i ] = static_cast<T>( m_dist( engine ) );
+            }
+        private:
+            IntegerDist<dist_t> m_dist;
+        };
+
+        /**
+        * \brief Generator of normally distributed values by Box-Muller transform
+        * \note Both values of every Box-Muller pair are used. Uniform values
+        *       for a whole block come from the bulk uniform kernel first,
+        *       then the transform runs as a separate loop over the block
+        */
+        template<typename T, template<typename> class IntegerDist, template<typename> class RealDist>
+        class normal_generator {
+            static_assert( std::is_floating_point<T>::value,
+                           "normal_generator expects floating point type" );
+        public:
+            /// Type of generated values
+            using result_type = T;
+
+            normal_generator( T mean, T stddev )
+                : m_mean{ mean }, m_stddev{ stddev } {
+                assert( stddev > T( 0 ) ); // standard deviation should be positive
+            }
+
+            /// Write 'size' random values to contiguous 'out'
+            template<typename Engine>
+            void operator()( Engine& engine, T* out, std::size_t size ) {
+                T uniforms[ bulk_block ];
+                while( size > 0 ) {
+                    const std::size_t count = size < bulk_block ? size : bulk_block;
+                    const std::size_t pairs = ( count + 1 ) / 2;
+                    m_uniform( engine, uniforms, 2 * pairs );
+                    transform( uniforms, pairs );
+                    std::copy( uniforms, uniforms + count, out );
+                    out += count;
+                    size -= count;
+                }
+            }
+        private:
+            /// Replace 'pairs' pairs of uniform values in-place by normal values
+            void transform( T* values, std::size_t pairs ) const {
+                const T two_pi = T( 6.283185307179586476925286766559L );
+                for( std::size_t i = 0; i < pairs; ++i ) {
+                    const T u1 = values[ 2 * i ], u2 = values[ 2 * i + 1 ];
+                    // 1 - u1 is in (0; 1], so the logarithm is finite
+                    const T complement = u1 < T( 1 ) ? T( 1 ) - u1 : ( std::numeric_limits<T>::min )( );
+                    const T radius = m_stddev * std::sqrt( T( -2 ) * std::log( complement ) );
+                    const T angle = two_pi * u2;
+                    values[ 2 * i ] = m_mean + radius * std::cos( angle );
+                    values[ 2 * i + 1 ] = m_mean + radius * std::sin( angle );
+                }
+            }
+        private:
+            range_generator<T, IntegerDist, RealDist> m_uniform{ T( 0 ), T( 1 ) };
+            T m_mean;
+            T m_stddev;
+        };
+
+        /**
+        * \brief Write 'size' values of 'generator' to contiguous 'out'
+        * \return Pointer past the last written value
+        */
+        template<typename Generator, typename Engine, typename T>
+        typename std::enable_if<std::is_same<T, typename Generator::result_type>::value
+            , T*>::type generate_n( Generator& generator, Engine& engine, T* out, std::size_t size ) {
+            generator( engine, out, size );
+            return out + size;
+        }
+
+        /**
+        * \brief Write 'size' values of 'generator' to 'out'
+        * \note Values are produced block by block on the stack
+        *       and then copied to the output
+        * \return Output iterator past the last written value
+        */
+        template<typename Generator, typename Engine, typename OutputIt>
+        OutputIt generate_n( Generator& generator, Engine& engine, OutputIt out, std::size_t size ) {
+            typename Generator::result_type block[ bulk_block ];
+            while( size > 0 ) {
+                const std::size_t count = size < bulk_block ? size : bulk_block;
+                generator( engine, block, count );
+                out = std::copy( block, block + count, out );
+                size -= count;
+            }
+            return out;
+        }
+
+        /**
+        * \brief Insert 'size' values of 'generator' at the end of 'container'
+        * \note Values are produced block by block on the stack,
+        *       every value is inserted by its own 'insert' call
+        */
+        template<typename Generator, typename Engine, typename Container>
+        void generate_insert( Generator& generator, Engine& engine,
+                              Container& container, std::size_t size ) {
+            typename Generator::result_type block[ bulk_block ];
+            while( size > 0 ) {
+                const std::size_t count = size < bulk_block ? size : bulk_block;
+                generator( engine, block, count );
+                for( std::size_t i = 0; i < count; ++i )
+                    container.insert( std::end( container ), block[ i ] );
+                size -= count;
+            }
+        }
+
+        /// True if Type has "resize" method and "data" method returning Value*
+        template<typename Type, typename Value, typename = void>
+        struct is_resizable_contiguous : public std::false_type {};
+
+        template<typename Type, typename Value>
+        struct is_resizable_contiguous<Type, Value, void_t<
+            decltype(std::declval<Type&>().resize(std::size_t(0))),
+            decltype(std::declval<Type&>().data())>> : public std::integral_constant<bool,
+                std::is_same<decltype(std::declval<Type&>().data()), Value*>::value> {};
+
+        /// Reserve 'size' elements in containers with "reserve" method
+        template<typename Container>
+        void try_reserve( Container& container, std::size_t size, std::true_type ) {
+            container.reserve( size );
+        }
+
+        /// Containers without "reserve" method are left as is
+        template<typename Container>
+        void try_reserve( Container&, std::size_t, std::false_type ) { }
+
+        /// Reserve 'size' elements if the container has "reserve" method
+        template<typename Container>
+        void try_reserve( Container& container, std::size_t size ) {
+            try_reserve( container, size, std::integral_constant<bool,
+                has_reserve<Container>::value>{ } );
+        }
+
+        /**
+        * \brief Append 'size' values of 'generator' to a contiguous container
+        *        by a single resize and bulk write through data()
+        */
+        template<typename Generator, typename Engine, typename Container>
+        void generate_into( Generator& generator, Engine& engine,
+                            Container& container, std::size_t size, std::true_type ) {
+            const std::size_t old_size = container.size( );
+            container.resize( old_size + size );
+            generate_n( generator, engine, container.data( ) + old_size, size );
+        }
+
+        /// Append 'size' values of 'generator' to a container by "insert" method
+        template<typename Generator, typename Engine, typename Container>
+        void generate_into( Generator& generator, Engine& engine,
+                            Container& container, std::size_t size, std::false_type ) {
+            generate_insert( generator, engine, container, size );
+        }
+
+        /**
+        * \brief Append 'size' values of 'generator' to 'container'
+        * \note Contiguous containers are resized once and written in bulk,
+        *       others get one "insert" call per value
+        */
+        template<typename Generator, typename Engine, typename Container>
+        void generate_into( Generator& generator, Engine& engine,
+                            Container& container, std::size_t size ) {
+            generate_into( generator, engine, container, size, std::integral_constant<bool,
+                is_resizable_contiguous<Container, typename Generator::result_type>::value>{ } );
+        }
+
+        /// True if Type has "data" method returning Value*
+        template<typename Type, typename Value, typename = void>
+        struct has_data_pointer : public std::false_type {};
+
+        template<typename Type, typename Value>
+        struct has_data_pointer<Type, Value, void_t<decltype(std::declval<Type&>().data())>>
+            : public std::is_same<decltype(std::declval<Type&>().data()), Value*> {};
+
+        /// Write N values of 'generator' straight to data() of array-like 'array'
+        template<std::size_t N, typename Generator, typename Engine, typename Array>
+        void generate_array( Generator& generator, Engine& engine, Array& array, std::true_type ) {
+            generate_n( generator, engine, array.data( ), N );
+        }
+
+        /**
+        * \brief Write N values of 'generator' to array-like 'array' without data()
+        * \note Values are generated to a local array, then assigned by index
+        *       in a loop with compile-time trip count
+        */
+        template<std::size_t N, typename Generator, typename Engine, typename Array>
+        void generate_array( Generator& generator, Engine& engine, Array& array, std::false_type ) {
+            typename Generator::result_type values[ N == 0 ? 1 : N ];
+            generator( engine, values, N );
+            for( std::size_t i = 0; i < N; ++i )
+                array[ i ] = values[ i ];
+        }
+
+        /// Write N values of 'generator' to all elements of array-like 'array'
+        template<std::size_t N, typename Generator, typename Engine, typename Array>
+        void generate_array( Generator& generator, Engine& engine, Array& array ) {
+            generate_array<N>( generator, engine, array, std::integral_constant<bool,
+                has_data_pointer<Array, typename Generator::result_type>::value>{ } );
+        }
+
+        /// Write values of 'generator' to [first, last) range
+        template<typename Generator, typename Engine, typename ForwardIt>
+        void generate( Generator& generator, Engine& engine, ForwardIt first, ForwardIt last ) {
+            generate_n( generator, engine, first,
+                        static_cast<std::size_t>( std::distance( first, last ) ) );
+        }
+
+        /**
+        * \brief Number of elements in one chunk of parallel algorithms
+        * \note Chunks never depend on the number of threads,
+        *       so results are the same for any thread count
+        */
+        constexpr std::size_t parallel_chunk = std::size_t{ 1 } << 16;
+
+        /// Key of independent substreams, drawn from a parent engine
+        struct substream_key {
+            std::uint32_t words[ 4 ];
+        };
+
+        /// Draw a new substream key from 'engine'
+        template<typename Engine>
+        substream_key make_substream_key( Engine& engine ) {
+            substream_key key;
+            for( auto& word : key.words )
+                word = static_cast<std::uint32_t>( engine( ) );
+            return key;
+        }
+
+        /// Return engine for the substream 'index', seeded by std::seed_seq
+        template<typename Engine>
+        Engine make_substream( const substream_key& key, std::size_t index ) {
+            const std::uint64_t wide_index = index;
+            std::seed_seq seq{ key.words[ 0 ], key.words[ 1 ], key.words[ 2 ], key.words[ 3 ],
+                               static_cast<std::uint32_t>( wide_index ),
+                               static_cast<std::uint32_t>( wide_index >> 32 ) };
+            return Engine{ seq };
+        }
+
+        /**
+        * \brief Call 'function' for every index in [0; count) on 'threads' threads
+        * \param threads The number of threads, 0 means std::thread::hardware_concurrency
+        * \note The calling thread is one of the workers
+        * \note If 'function' throws, the remaining indices are skipped and
+        *       the first exception is rethrown after all threads are joined
+        */
+        template<typename Function>
+        void parallel_for( std::size_t count, std::size_t threads, Function function ) {
+            if( 0 == threads )
+                threads = std::thread::hardware_concurrency( );
+            if( threads > count )
+                threads = count;
+            if( threads < 2 ) {
+                for( std::size_t i = 0; i < count; ++i )
+                    function( i );
+                return;
+            }
+
+            std::atomic<std::size_t> next{ 0 };
+            std::vector<std::exception_ptr> errors( threads );
+            auto worker = [ &next, &errors, count, &function ]( std::size_t id ) {
+                try {
+                    for( std::size_t i = next++; i < count; i = next++ )
+                        function( i );
+                } catch( ... ) {
+                    errors[ id ] = std::current_exception( );
+                    next = count;
+                }
+            };
+
+            std::vector<std::thread> pool;
+            pool.reserve( threads - 1 );
+            try {
+                for( std::size_t i = 1; i < threads; ++i )
+                    pool.emplace_back( worker, i );
+            } catch( ... ) {
+                next = count;
+                for( auto& thread : pool )
+                    thread.join( );
+                throw;
+            }
+            worker( 0 );
+            for( auto& thread : pool )
+                thread.join( );
+            for( const auto& error : errors )
+                if( error )
+                    std::rethrow_exception( error );
+        }
+
+        /**
+        * \brief Return the high 64 bits of the 128-bit product a * b
+        *        and write the low 64 bits to 'low'
+        */
+        inline std::uint64_t multiply_high( std::uint64_t a, std::uint64_t b, std::uint64_t& low ) {
+#ifdef __SIZEOF_INT128__
+            __extension__ typedef unsigned __int128 uint128;
+            const uint128 product = static_cast<uint128>( a ) * b;
+            low = static_cast<std::uint64_t>( product );
+            return static_cast<std::uint64_t>( product >> 64 );
+#else
+            const std::uint64_t a_low = a & 0xFFFFFFFFu, a_high = a >> 32;
+            const std::uint64_t b_low = b & 0xFFFFFFFFu, b_high = b >> 32;
+            const std::uint64_t low_low = a_low * b_low, high_low = a_high * b_low;
+            const std::uint64_t low_high = a_low * b_high, high_high = a_high * b_high;
+            const std::uint64_t cross = ( low_low >> 32 ) + ( high_low & 0xFFFFFFFFu ) + low_high;
+            low = cross << 32 | ( low_low & 0xFFFFFFFFu );
+            return high_high + ( high_low >> 32 ) + ( cross >> 32 );
+#endif
+        }
+
+        /// Return 64 random bits from a 32-bit engine
+        template<typename Engine>
+        std::uint64_t next_wide_word( Engine& engine, std::integral_constant<int, 32> ) {
+            const std::uint64_t high = static_cast<std::uint32_t>( engine( ) );
+            return high << 32 | static_cast<std::uint32_t>( engine( ) );
+        }
+
+        /// Return 64 random bits from a 64-bit engine
+        template<typename Engine>
+        std::uint64_t next_wide_word( Engine& engine, std::integral_constant<int, 64> ) {
+            return static_cast<std::uint64_t>( engine( ) );
+        }
+
+        /// Return 64 random bits from any other engine
+        template<typename Engine>
+        std::uint64_t next_wide_word( Engine& engine, std::integral_constant<int, 0> ) {
+            const std::uint64_t high = next_word( engine, std::integral_constant<int, 0>{ } );
+            return high << 32 | next_word( engine, std::integral_constant<int, 0>{ } );
+        }
+
+        /// Return 64 random bits from 'engine'
+        template<typename Engine>
+        std::uint64_t next_wide_word( Engine& engine ) {
+            return next_wide_word( engine, std::integral_constant<int, engine_bits<Engine>::value>{ } );
+        }
+
+        /**
+        * \brief Write 'count' random indices to 'out', out[ i ] in [0; bound - i),
+        *        drawn from one 64-bit word while it is not rejected
+        *        (batched ranged integers, Brackett-Rozinsky and Lemire)
+        * \note bound * (bound - 1) * ... * (bound - count + 1) should fit 64 bits
+        */
+        template<typename Engine>
+        void batched_indices( Engine& engine, std::uint64_t bound,
+                              std::size_t count, std::uint64_t* out ) {
+            using bits = std::integral_constant<int, engine_bits<Engine>::value>;
+            std::uint64_t low = next_wide_word( engine, bits{ } );
+            for( std::size_t i = 0; i < count; ++i )
+                out[ i ] = multiply_high( bound - i, low, low );
+
+            std::uint64_t product = 1;
+            for( std::size_t i = 0; i < count; ++i )
+                product *= bound - i;
+            if( low < product ) {
+                // 2^64 mod product, the words giving low remainders are rejected
+                const std::uint64_t threshold = ( 0 - product ) % product;
+                while( low < threshold ) {
+                    low = next_wide_word( engine, bits{ } );
+                    for( std::size_t i = 0; i < count; ++i )
+                        out[ i ] = multiply_high( bound - i, low, low );
+                }
+            }
+        }
+
+        /**
+        * \brief Call 'visit( i, j )' for every i in [0; count) with random j
+        *        in [i; size), which are the index pairs of Fisher-Yates shuffle
+        * \note Several indices are drawn from every 64-bit word, the smaller
+        *       the remaining range, the more indices, up to 6
+        */
+        template<typename Engine, typename Visit>
+        void fisher_yates_indices( Engine& engine, std::uint64_t size, std::uint64_t count,
+                                   Visit visit, std::true_type ) {
+            std::uint64_t indices[ 6 ];
+            for( std::uint64_t i = 0; i < count; ) {
+                const std::uint64_t left = size - i;
+                const std::size_t batch =
+                      left > ( std::uint64_t{ 1 } << 30 ) ? 1
+                    : left > ( std::uint64_t{ 1 } << 19 ) ? 2
+                    : left > ( std::uint64_t{ 1 } << 14 ) ? 3
+                    : left > ( std::uint64_t{ 1 } << 11 ) ? 4
+                    : left > ( std::uint64_t{ 1 } << 9 ) ? 5 : 6;
+                const std::size_t draws = batch < count - i ? batch : static_cast<std::size_t>( count - i );
+                batched_indices( engine, left, draws, indices );
+                for( std::size_t j = 0; j < draws; ++j )
+                    visit( i + j, i + j + indices[ j ] );
+                i += draws;
+            }
+        }
+
+        /// Fisher-Yates index pairs from engines without full 32 or 64-bit output
+        template<typename Engine, typename Visit>
+        void fisher_yates_indices( Engine& engine, std::uint64_t size, std::uint64_t count,
+                                   Visit visit, std::false_type ) {
+            using dist_t = std::uniform_int_distribution<std::uint64_t>;
+            dist_t dist;
+            for( std::uint64_t i = 0; i < count; ++i )
+                visit( i, dist( engine, dist_t::param_type{ i, size - 1 } ) );
+        }
+
+        /// Call 'visit( i, j )' for every i in [0; count) with random j in [i; size)
+        template<typename Engine, typename Visit>
+        void fisher_yates_indices( Engine& engine, std::uint64_t size, std::uint64_t count, Visit visit ) {
+            fisher_yates_indices( engine, size, count, visit,
+                std::integral_constant<bool, 0 != engine_bits<Engine>::value>{ } );
+        }
+
+        /**
+        * \brief Move k random elements of [first, last) range to its beginning,
+        *        in random order
+        * \return Iterator past the k-th element
+        */
+        template<typename RandomIt, typename Engine>
+        RandomIt partial_shuffle( RandomIt first, RandomIt last, std::size_t k, Engine& engine ) {
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+            const auto size = static_cast<std::uint64_t>( last - first );
+            const std::uint64_t count = k < size ? k : size;
+            // The last element of a full shuffle has nowhere to go
+            const std::uint64_t swaps = count < size ? count : size - ( 0 < size ? 1 : 0 );
+            fisher_yates_indices( engine, size, swaps, [ first ]( std::uint64_t i, std::uint64_t j ) {
+                std::iter_swap( first + static_cast<difference_type>( i ),
+                                first + static_cast<difference_type>( j ) );
+            } );
+            return first + static_cast<difference_type>( count );
+        }
+
+        /**
+        * \brief Copy k random elements of [first, last) range to 'out',
+        *        in random order, without modifying the range
+        * \note Sparse Fisher-Yates shuffle: only displaced indices are
+        *       remembered, so time and memory are O(k)
+        * \return Output iterator past the last written element
+        */
+        template<typename RandomIt, typename OutputIt, typename Engine>
+        OutputIt sample( RandomIt first, RandomIt last, std::size_t k, OutputIt out, Engine& engine ) {
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+            const auto size = static_cast<std::uint64_t>( last - first );
+            const std::uint64_t count = k < size ? k : size;
+
+            std::unordered_map<std::uint64_t, std::uint64_t> displaced;
+            displaced.reserve( static_cast<std::size_t>( count ) );
+            const auto at = [ &displaced ]( std::uint64_t index ) {
+                const auto it = displaced.find( index );
+                return displaced.end( ) == it ? index : it->second;
+            };
+            fisher_yates_indices( engine, size, count, [ & ]( std::uint64_t i, std::uint64_t j ) {
+                const std::uint64_t picked = at( j );
+                displaced[ j ] = at( i );
+                *out = first[ static_cast<difference_type>( picked ) ];
+                ++out;
+            } );
+            return out;
+        }
+
+        /**
+        * \brief Call 'visit( offset )' for 'count' distinct random offsets
+        *        in [0; span] by Floyd's algorithm
+        * \note Time and memory are O(count), the range is never materialized.
+        *       Offsets are uniform as a set, not in a random order
+        * \param span The largest offset
+        * \throw std::invalid_argument if 'count' exceeds span + 1
+        */
+        template<typename IntegerDist, typename Engine, typename Visit>
+        void unique_offsets( Engine& engine, std::uint64_t span, std::uint64_t count, Visit visit ) {
+            if( 0 != count && count - 1 > span )
+                throw std::invalid_argument( "effolkronium::get_unique: not enough distinct values in the range" );
+            std::unordered_set<std::uint64_t> taken;
+            taken.reserve( static_cast<std::size_t>( count ) );
+            // j runs over the last 'count' offsets of [0; span]
+            for( std::uint64_t j = span - ( count - 1 ), i = 0; i < count; ++i, ++j ) {
+                std::uint64_t offset = IntegerDist{ 0, j }( engine );
+                if( !taken.insert( offset ).second ) {
+                    offset = j; // j is larger than every taken offset
+                    taken.insert( j );
+                }
+                visit( offset );
+            }
+        }
+
+        /**
+        * \brief Fisher-Yates shuffle of [first, last) range with several
+        *        indices drawn from every 64-bit word
+        * \note The smaller the remaining range, the more indices
+        *       are taken from one word, up to 6
+        * \note Runs from the back of the range, unlike partial_shuffle,
+        *       and makes size - 1 draws
+        */
+        template<typename RandomIt, typename Engine>
+        void shuffle( RandomIt first, RandomIt last, Engine& engine, std::true_type ) {
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+            std::uint64_t size = static_cast<std::uint64_t>( last - first );
+            std::uint64_t indices[ 6 ];
+            while( size > 1 ) {
+                const std::size_t batch =
+                      size > ( std::uint64_t{ 1 } << 30 ) ? 1
+                    : size > ( std::uint64_t{ 1 } << 19 ) ? 2
+                    : size > ( std::uint64_t{ 1 } << 14 ) ? 3
+                    : size > ( std::uint64_t{ 1 } << 11 ) ? 4
+                    : size > ( std::uint64_t{ 1 } << 9 ) ? 5 : 6;
+                const std::size_t count = batch < size ? batch : static_cast<std::size_t>( size - 1 );
+                batched_indices( engine, size, count, indices );
+                for( std::size_t i = 0; i < count; ++i )
+                    std::iter_swap( first + static_cast<difference_type>( size - 1 - i ),
+                                    first + static_cast<difference_type>( indices[ i ] ) );
+                size -= count;
+            }
+        }
+
+        /// Engines without full 32 or 64-bit output are used by std::shuffle
+        template<typename RandomIt, typename Engine>
+        void shuffle( RandomIt first, RandomIt last, Engine& engine, std::false_type ) {
+            std::shuffle( first, last, engine );
+        }
+
+        /// Reorder [first, last) range by Fisher-Yates shuffle
+        template<typename RandomIt, typename Engine>
+        void shuffle( RandomIt first, RandomIt last, Engine& engine ) {
+            shuffle( first, last, engine,
+                std::integral_constant<bool, 0 != engine_bits<Engine>::value>{ } );
+        }
+
+        /// Return random value in (0; 1) range
+        template<typename Engine>
+        double open_canonical( Engine& engine ) {
+            double value = canonical<double>( engine );
+            while( value <= 0. )
+                value = canonical<double>( engine );
+            return value;
+        }
+
+        /**
+        * \brief Reservoir sampling by Algorithm L (Li): call 'keep( slot, it )'
+        *        for every element 'it' of [first, last) which enters the
+        *        reservoir of 'k' slots, replacing the element in 'slot'
+        * \note Single pass. Elements between replacements are skipped by
+        *       geometric jumps, so only O(k log(n / k)) random numbers are drawn
+        * \note Slots are drawn by IntegerDist
+        * \return The number of filled slots, less than k for short ranges
+        */
+        template<typename IntegerDist, typename InputIt, typename Engine, typename Keep>
+        std::size_t reservoir( InputIt first, InputIt last, std::size_t k, Engine& engine, Keep keep ) {
+            using slot_t = typename IntegerDist::result_type;
+            std::size_t filled = 0;
+            for( ; filled < k && first != last; ++first )
+                keep( filled++, first );
+            if( filled < k || 0 == k )
+                return filled;
+
+            const double size = static_cast<double>( k );
+            double weight = std::exp( std::log( open_canonical( engine ) ) / size );
+            while( first != last ) {
+                const double skip = std::floor(
+                    std::log( open_canonical( engine ) ) / std::log1p( -weight ) );
+                if( !( skip < 1e19 ) )
+                    break; // beyond any range
+                for( auto left = static_cast<std::uint64_t>( skip ); 0 != left && first != last; --left )
+                    ++first;
+                if( first == last )
+                    break;
+                keep( static_cast<std::size_t>(
+                    IntegerDist{ 0, static_cast<slot_t>( k - 1 ) }( engine ) ), first );
+                ++first;
+                weight *= std::exp( std::log( open_canonical( engine ) ) / size );
+            }
+            return filled;
+        }
+
+        /// Return random iterator from random-access range, last if it is empty
+        template<typename IntegerDist, typename RandomIt, typename Engine>
+        RandomIt random_iterator( RandomIt first, RandomIt last, Engine& engine,
+                                  std::random_access_iterator_tag ) {
+            const auto size = last - first;
+            if( 0 == size ) return last;
+            return first + IntegerDist{ 0, size - 1 }( engine );
+        }
+
+        /// Return random iterator from range in a single pass, last if it is empty
+        template<typename IntegerDist, typename InputIt, typename Engine>
+        InputIt random_iterator( InputIt first, InputIt last, Engine& engine,
+                                 std::input_iterator_tag ) {
+            InputIt chosen = last;
+            reservoir<IntegerDist>( first, last, 1, engine, [ &chosen ]( std::size_t, InputIt it ) {
+                chosen = it;
+            } );
+            return chosen;
+        }
+
+        /**
+        * \brief Copy k random elements of [first, last) range to random-access
+        *        'out' in a single pass, in random order
+        * \return Output iterator past the last written element
+        */
+        template<typename IntegerDist, typename InputIt, typename RandomOut, typename Engine>
+        RandomOut reservoir_sample( InputIt first, InputIt last, std::size_t k,
+                                    RandomOut out, Engine& engine ) {
+            using difference_type = typename std::iterator_traits<RandomOut>::difference_type;
+            const std::size_t filled = reservoir<IntegerDist>( first, last, k, engine,
+                [ out ]( std::size_t slot, InputIt it ) {
+                    out[ static_cast<difference_type>( slot ) ] = *it;
+                } );
+            const RandomOut end = out + static_cast<difference_type>( filled );
+            shuffle( out, end, engine );
+            return end;
+        }
+
+        /// Return vector of k random elements of random-access range, in random order
+        template<typename IntegerDist, typename RandomIt, typename Engine>
+        std::vector<typename std::iterator_traits<RandomIt>::value_type> sample_vector(
+                RandomIt first, RandomIt last, std::size_t k, Engine& engine,
+                std::random_access_iterator_tag ) {
+            const auto size = static_cast<std::size_t>( last - first );
+            std::vector<typename std::iterator_traits<RandomIt>::value_type> selected;
+            selected.reserve( k < size ? k : size );
+            sample( first, last, k, std::back_inserter( selected ), engine );
+            return selected;
+        }
+
+        /// Return vector of k random elements of range in a single pass, in random order
+        template<typename IntegerDist, typename InputIt, typename Engine>
+        std::vector<typename std::iterator_traits<InputIt>::value_type> sample_vector(
+                InputIt first, InputIt last, std::size_t k, Engine& engine,
+                std::input_iterator_tag ) {
+            std::vector<typename std::iterator_traits<InputIt>::value_type> selected;
+            reservoir<IntegerDist>( first, last, k, engine, [ &selected ]( std::size_t slot, InputIt it ) {
+                if( selected.size( ) == slot )
+                    selected.push_back( *it );
+                else
+                    selected[ slot ] = *it;
+            } );
+            shuffle( selected.begin( ), selected.end( ), engine );
+            return selected;
+        }
+
+        /**
+        * \brief Merge two uniformly shuffled adjacent ranges [first, middle)
+        *        and [middle, last) into one uniformly shuffled range (MergeShuffle)
+        * \note Elements are taken from either side by random bits until one side
+        *       is exhausted, the rest is inserted by Fisher-Yates steps
+        */
+        template<typename RandomIt, typename Engine>
+        void merge_shuffled( RandomIt first, RandomIt middle, RandomIt last, Engine& engine ) {
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+            bit_stream<Engine> coin{ engine };
+            RandomIt it = first;
+            for( ; ; ++it ) {
+                if( coin( ) ) {
+                    if( middle == last )
+                        break;
+                    std::iter_swap( it, middle++ );
+                } else if( it == middle ) {
+                    break;
+                }
+            }
+            for( ; it != last; ++it ) {
+                using dist_t = std::uniform_int_distribution<difference_type>;
+                const difference_type index = dist_t{ 0, it - first }( engine );
+                std::iter_swap( it, first + index );
+            }
+        }
+
+        /**
+        * \brief Shuffle [first, last) range on several threads (MergeShuffle)
+        * \note The range is split into a power of two blocks of at most
+        *       'parallel_chunk' elements, which are shuffled independently and
+        *       then merged pairwise level by level. Every block and every merge
+        *       has its own substream keyed by 'engine', and the block count
+        *       depends only on the range size, so the result never depends
+        *       on the number of threads
+        */
+        template<typename RandomIt, typename Engine>
+        void parallel_shuffle( RandomIt first, RandomIt last, Engine& engine, std::size_t threads ) {
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+            const substream_key key = make_substream_key( engine );
+            const auto size = static_cast<std::size_t>( last - first );
+
+            std::size_t blocks = 1;
+            while( size / blocks > parallel_chunk )
+                blocks *= 2;
+
+            // Iterator to the start of block 'index', blocks differ in size by at most one
+            const std::size_t base = size / blocks, extra = size % blocks;
+            const auto bound = [ = ]( std::size_t index ) {
+                return first + static_cast<difference_type>(
+                    index * base + ( index < extra ? index : extra ) );
+            };
+
+            parallel_for( blocks, threads, [ & ]( std::size_t block ) {
+                Engine substream = make_substream<Engine>( key, block );
+                shuffle( bound( block ), bound( block + 1 ), substream );
+            } );
+
+            std::size_t stream = blocks;
+            for( std::size_t width = 1; width < blocks; width *= 2 ) {
+                const std::size_t merges = blocks / ( 2 * width );
+                parallel_for( merges, threads, [ & ]( std::size_t merge ) {
+                    Engine substream = make_substream<Engine>( key, stream + merge );
+                    merge_shuffled( bound( 2 * merge * width ), bound( ( 2 * merge + 1 ) * width ),
+                                    bound( ( 2 * merge + 2 ) * width ), substream );
+                } );
+                stream += merges;
+            }
+        }
+
+        /// Approximate size in bytes of one bucket of bucketed shuffle
+        constexpr std::size_t shuffle_bucket_bytes = std::size_t{ 1 } << 18;
+
+        /**
+        * \brief Draw bucket labels in [0; buckets) for 'size' elements
+        *        and pass every label with its element index to 'visit'
+        * \note The same engine state always produces the same labels
+        */
+        template<typename Engine, typename Visit>
+        void bucket_labels( Engine& engine, std::size_t size, std::size_t buckets, Visit visit ) {
+            range_generator<std::uint32_t, std::uniform_int_distribution,
+                std::uniform_real_distribution> generator{
+                    0u, static_cast<std::uint32_t>( buckets - 1 ) };
+            std::uint32_t labels[ bulk_block ];
+            for( std::size_t done = 0; done < size; ) {
+                const std::size_t count = size - done < bulk_block ? size - done : bulk_block;
+                generator( engine, labels, count );
+                for( std::size_t i = 0; i < count; ++i )
+                    visit( done + i, labels[ i ] );
+                done += count;
+            }
+        }
+
+        /**
+        * \brief Shuffle [first, last) range by scattering the elements to
+        *        cache-sized random buckets and shuffling every bucket
+        * \note Every element gets an independent uniform bucket label, elements
+        *       are grouped by label, then every group is shuffled, which gives
+        *       a uniformly random permutation. Labels are counted in the first
+        *       pass and drawn again from a copy of the engine in the second one,
+        *       so they are never stored
+        */
+        template<typename RandomIt, typename Engine>
+        void bucketed_shuffle( RandomIt first, RandomIt last, Engine& engine ) {
+            using value_type = typename std::iterator_traits<RandomIt>::value_type;
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+            const auto size = static_cast<std::size_t>( last - first );
+            const std::size_t per_bucket = shuffle_bucket_bytes / sizeof( value_type ) + 1;
+            const std::size_t buckets = ( size + per_bucket - 1 ) / per_bucket;
+            if( buckets < 2 || buckets > std::size_t{ 0xFFFFFFFF } ) {
+                shuffle( first, last, engine );
+                return;
+            }
+
+            const Engine replay = engine;
+            std::vector<std::size_t> offsets( buckets + 1, 0 );
+            bucket_labels( engine, size, buckets, [ &offsets ]( std::size_t, std::uint32_t label ) {
+                ++offsets[ label + 1 ];
+            } );
+            for( std::size_t i = 1; i <= buckets; ++i )
+                offsets[ i ] += offsets[ i - 1 ];
+
+            {
+                std::vector<value_type> source( std::make_move_iterator( first ),
+                                                std::make_move_iterator( last ) );
+                std::vector<std::size_t> positions( offsets.begin( ), offsets.end( ) - 1 );
+                Engine labels = replay;
+                bucket_labels( labels, size, buckets, [ & ]( std::size_t index, std::uint32_t label ) {
+                    first[ static_cast<difference_type>( positions[ label ]++ ) ] =
+                        std::move( source[ index ] );
+                } );
+            }
+
+            for( std::size_t bucket = 0; bucket < buckets; ++bucket )
+                shuffle( first + static_cast<difference_type>( offsets[ bucket ] ),
+                         first + static_cast<difference_type>( offsets[ bucket + 1 ] ), engine );
+        }
+
+        /**
+        * \brief Write values of 'generator' to [first, last) range
+        *        chunk by chunk on several threads
+        * \note Every chunk is written from its own substream,
+        *       keyed by 'engine' and the chunk index
+        */
+        template<typename Generator, typename Engine, typename RandomIt>
+        void parallel_generate( const Generator& generator, Engine& engine,
+                                RandomIt first, RandomIt last, std::size_t threads ) {
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+            const substream_key key = make_substream_key( engine );
+            const auto size = static_cast<std::size_t>( last - first );
+            const std::size_t chunks = ( size + parallel_chunk - 1 ) / parallel_chunk;
+
+            parallel_for( chunks, threads, [ & ]( std::size_t chunk ) {
+                Generator chunk_generator = generator;
+                Engine substream = make_substream<Engine>( key, chunk );
+                const std::size_t begin = chunk * parallel_chunk;
+                const std::size_t count = size - begin < parallel_chunk
+                                        ? size - begin : parallel_chunk;
+                generate_n( chunk_generator, substream,
+                            first + static_cast<difference_type>( begin ), count );
+            } );
+        }
+
+        /// Base of range views, std::ranges::view_base when ranges are available
+#ifdef __cpp_lib_ranges
+        using view_base = std::ranges::view_base;
+#else
+        struct view_base { };
+#endif
+
+        /**
+        * \brief Lazy input range of values of 'Generator' drawn from 'Engine'
+        * \note Values are generated block by block into a buffer owned by
+        *       the view, so the engine is advanced in blocks of values
+        * \note Iterators point to the view, like std::ranges::istream_view:
+        *       they are invalidated when the view is moved or destroyed
+        */
+        template<typename Generator, typename Engine>
+        class random_view : public view_base {
+        public:
+            /// Type of generated values
+            using value_type = typename Generator::result_type;
+
+            /// Input iterator over generated values
+            class iterator {
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using value_type = typename Generator::result_type;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const value_type*;
+                using reference = const value_type&;
+
+                /// Holds the value for '*it++' expressions
+                class postfix_proxy {
+                public:
+                    explicit postfix_proxy( const value_type& value ) : m_value{ value } { }
+                    const value_type& operator*( ) const { return m_value; }
+                private:
+                    value_type m_value;
+                };
+
+                /// Construct end iterator
+                iterator( ) = default;
+
+                explicit iterator( random_view* parent ) : m_view{ parent } { }
+
+                reference operator*( ) const { return m_view->current( ); }
+
+                pointer operator->( ) const { return &m_view->current( ); }
+
+                iterator& operator++( ) {
+                    m_view->advance( );
+                    return *this;
+                }
+
+                postfix_proxy operator++( int ) {
+                    postfix_proxy proxy{ **this };
+                    ++*this;
+                    return proxy;
+                }
+
+                friend bool operator==( const iterator& lhs, const iterator& rhs ) {
+                    return lhs.at_end( ) == rhs.at_end( )
+                        && ( lhs.at_end( ) || lhs.m_view == rhs.m_view );
+                }
+
+                friend bool operator!=( const iterator& lhs, const iterator& rhs ) {
+                    return !( lhs == rhs );
+                }
+            private:
+                bool at_end( ) const {
+                    return nullptr == m_view || m_view->exhausted( );
+                }
+            private:
+                random_view* m_view = nullptr;
+            };
+
+            /// Default constructed view is empty
+            random_view( ) = default;
+
+            /// Infinite view
+            random_view( const Generator& generator, Engine& engine )
+                : m_generator{ generator }, m_engine{ &engine } { }
+
+            /// View of 'count' values
+            random_view( const Generator& generator, Engine& engine, std::size_t count )
+                : m_generator{ generator }, m_engine{ &engine },
+                  m_left{ count }, m_sized{ true } { }
+
+            /// Start of the values, generates the first block
+            iterator begin( ) {
+                if( m_position == m_filled )
+                    refill( );
+                return iterator{ this };
+            }
+
+            /// End of the values, never reached in infinite view
+            iterator end( ) {
+                return iterator{ };
+            }
+        private:
+            const value_type& current( ) const {
+                return m_buffer[ m_position ];
+            }
+
+            void advance( ) {
+                if( ++m_position == m_filled )
+                    refill( );
+            }
+
+            bool exhausted( ) const {
+                return m_position == m_filled;
+            }
+
+            void refill( ) {
+                if( nullptr == m_engine )
+                    return;
+                const std::size_t count = m_sized && m_left < bulk_block ? m_left : bulk_block;
+                if( 0 == count )
+                    return;
+                m_generator( *m_engine, m_buffer, count );
+                if( m_sized )
+                    m_left -= count;
+                m_position = 0;
+                m_filled = count;
+            }
+        private:
+            Generator m_generator{ value_type( ), value_type( ) };
+            Engine* m_engine = nullptr;
+            std::size_t m_left = 0;
+            bool m_sized = false;
+            std::size_t m_position = 0;
+            std::size_t m_filled = 0;
+            value_type m_buffer[ bulk_block ];
+        };
+
+        /**
+        * \brief Flip bits of 'words' at positions in [0; nbits) where independent
+        *        Bernoulli trials with probability 'p' succeed
+        * \note The gaps between successes are geometric, so the cost is
+        *       proportional to the number of set bits
+        */
+        template<typename Engine>
+        void scatter_bits( Engine& engine, std::uint64_t* words, std::size_t nbits, double p ) {
+            const double scale = 1. / std::log1p( -p );
+            for( std::size_t bit = 0; ; ++bit ) {
+                const double gap = std::floor( std::log( open_canonical( engine ) ) * scale );
+                if( !( gap < static_cast<double>( nbits - bit ) ) )
+                    return;
+                bit += static_cast<std::size_t>( gap );
+                words[ bit / 64 ] ^= std::uint64_t{ 1 } << ( bit % 64 );
+            }
+        }
+
+        /**
+        * \brief Fill 'words' by bits which are set with probability 'p'
+        *        rounded to 32 binary digits
+        * \note Every bit compares its own uniform number, built from random
+        *       words one binary digit at a time, to the binary expansion of p.
+        *       Digits go from the most significant one and a word is done once
+        *       all its bits differ from p in some digit, which takes about
+        *       log2(64) + 2 random words
+        */
+        template<typename Engine>
+        void expansion_bits( Engine& engine, std::uint64_t* words, std::size_t size, double p ) {
+            const auto digits = static_cast<std::uint32_t>( p * 4294967296. + .5 );
+            std::uint32_t lowest = 1;
+            for( ; 0 == ( digits & lowest ); lowest <<= 1 ) { } // trailing zero digits decide nothing
+            for( std::size_t i = 0; i < size; ++i ) {
+                std::uint64_t word = 0, undecided = ~std::uint64_t{ 0 };
+                for( std::uint32_t digit = 0x80000000u; 0 != undecided && digit >= lowest; digit >>= 1 ) {
+                    const std::uint64_t random = next_wide_word( engine );
+                    if( 0 != ( digits & digit ) ) {
+                        word |= undecided & ~random; // uniform digit 0 < 1, below p
+                        undecided &= random;
+                    } else {
+                        undecided &= ~random; // uniform digit 1 > 0, above p
+                    }
+                }
+                words[ i ] = word; // bits equal to p in every digit are not below it
+            }
+        }
+
+        /**
+        * \brief Fill 'words' by 'nbits' independent bits which are set
+        *        with probability 'p', bits past 'nbits' in the last word are cleared
+        * \note Sparse and dense bits are placed by geometric skipping,
+        *       others are produced a word at a time from the binary expansion of p
+        */
+        template<typename Engine>
+        void bernoulli_bits( Engine& engine, std::uint64_t* words, std::size_t nbits, double p ) {
+            const std::size_t size = ( nbits + 63 ) / 64;
+            const std::uint64_t ones = ~std::uint64_t{ 0 };
+            if( 0. == p || 1. == p ) { // no gaps to skip
+                std::fill( words, words + size, 0. == p ? 0 : ones );
+            } else if( p < .125 ) {
+                std::fill( words, words + size, 0 );
+                scatter_bits( engine, words, nbits, p );
+            } else if( p > .875 ) {
+                std::fill( words, words + size, ones );
+                scatter_bits( engine, words, nbits, 1. - p );
+            } else {
+                expansion_bits( engine, words, size, p );
+            }
+            if( 0 != nbits % 64 )
+                words[ size - 1 ] &= ( std::uint64_t{ 1 } << ( nbits % 64 ) ) - 1;
+        }
+
+        /**
+        * \brief Write 'size' values to 'out', value i is uniform
+        *        in the stratum [i / size; (i + 1) / size)
+        * \note Offsets inside strata are produced in blocks by 'uniform'.
+        *       Rounding of a value is corrected by moving it by ulps until
+        *       it is inside its stratum, which is checked exactly by fma
+        *       in a type holding every index. Strata narrower than
+        *       the precision of the value type hold no values at all
+        * \return Output iterator past the last written value
+        */
+        template<typename Uniform, typename Engine, typename OutputIt>
+        OutputIt stratified_fill( Uniform& uniform, Engine& engine, OutputIt out, std::size_t size ) {
+            using T = typename Uniform::result_type;
+            using wide = typename std::conditional<
+                std::is_same<T, long double>::value, long double, double>::type;
+            const wide count = static_cast<wide>( size );
+            const wide scale = wide( 1 ) / count;
+            T block[ bulk_block ];
+            for( std::size_t done = 0; done < size; ) {
+                const std::size_t block_size = size - done < bulk_block ? size - done : bulk_block;
+                uniform( engine, block, block_size );
+                for( std::size_t i = 0; i < block_size; ++i, ++done, ++out ) {
+                    const wide lower = static_cast<wide>( done );
+                    T value = static_cast<T>( ( lower + static_cast<wide>( block[ i ] ) ) * scale );
+                    // value * size should be in [lower; lower + 1)
+                    while( std::fma( static_cast<wide>( value ), count, -lower ) < wide( 0 ) )
+                        value = std::nextafter( value, T( 2 ) );
+                    while( std::fma( static_cast<wide>( value ), count, -( lower + 1 ) ) >= wide( 0 ) )
+                        value = std::nextafter( value, T( 0 ) );
+                    *out = value;
+                }
+            }
+            return out;
+        }
+
+        /**
+        * \brief Write Latin hypercube design of 'size' points in 'dims' dimensions
+        *        to 'out' as structure of arrays: coordinate d of point i is at out[ d * size + i ]
+        * \note Every dimension is a stratified fill whose strata are shuffled,
+        *       so each stratum of each dimension holds exactly one point
+        * \return Iterator past the last written value
+        */
+        template<typename Uniform, typename Engine, typename RandomIt>
+        RandomIt latin_hypercube( Uniform& uniform, Engine& engine,
+                                  std::size_t size, std::size_t dims, RandomIt out ) {
+            for( std::size_t d = 0; d < dims; ++d ) {
+                const RandomIt next = stratified_fill( uniform, engine, out, size );
+                shuffle( out, next, engine );
+                out = next;
+            }
+            return out;
+        }
+
     } // namespace details
 
     /// Default seeder for 'random' classes
@@ -168,11 +1851,370 @@ namespace effolkronium {
             return seed_seq;
         }
     private:
-        std::seed_seq seed_seq{ {
-                static_cast<std::uintmax_t>( std::random_device{ }( ) ),
-                static_cast<std::uintmax_t>( std::chrono::steady_clock::now( )
-                                             .time_since_epoch( ).count( ) ),
-        } };
+        std::seed_seq seed_seq{ {
+                static_cast<std::uintmax_t>( std::random_device{ }( ) ),
+                static_cast<std::uintmax_t>( std::chrono::steady_clock::now( )
+                                             .time_since_epoch( ).count( ) ),
+        } };
+    };
+
+    /**
+    * \brief Discrete distribution over indices [0; size) by the
+    *        guide table method (Chen & Asau)
+    * \note A guide of 'size' entries points close to the answer in the
+    *       cumulative weights, so a draw costs O(1) expected steps and
+    *       the setup is a single prefix sum
+    * \note Sampling is by inversion: larger uniform values never map to
+    *       smaller indices, which keeps common random numbers aligned
+    * \param RealType The type of the weights and their sums
+    */
+    template<typename RealType = double>
+    class guide_table {
+        static_assert( details::is_uniform_real<RealType>::value,
+                       "RealType should be float, double or long double" );
+    public:
+        /// Type of generated indices
+        using result_type = std::size_t;
+
+        /**
+        * \brief Build the table from weights in [first, last) range
+        * \note Weights should be non-negative with positive sum
+        */
+        template<typename InputIt>
+        guide_table( InputIt first, InputIt last ) {
+            for( ; first != last; ++first ) {
+                assert( RealType( *first ) >= RealType( 0 ) );
+                m_cumulative.push_back( RealType( *first ) );
+            }
+            build( );
+        }
+
+        /**
+        * \brief Build the table from weights in initializer_list
+        * \note Weights should be non-negative with positive sum
+        */
+        guide_table( std::initializer_list<RealType> weights )
+            : guide_table( weights.begin( ), weights.end( ) ) { }
+
+        /// Return random index by internal uniform number from 'engine'
+        template<typename Engine>
+        result_type operator()( Engine& engine ) const {
+            return quantile( details::canonical<RealType>( engine ) );
+        }
+
+        /**
+        * \brief Return index for a given uniform number
+        * \param u A number in [0; 1) range
+        * \return The smallest index whose cumulative weight exceeds u * total
+        */
+        result_type quantile( RealType u ) const {
+            assert( 0 <= u && 1 > u ); // out of [0; 1) range
+            return details::guide_search( m_cumulative.data( ), m_last,
+                m_guide.data( ), m_guide.size( ), u );
+        }
+
+        /// Number of weights
+        std::size_t size( ) const { return m_cumulative.size( ); }
+
+        /// Sum of all weights
+        RealType total( ) const { return m_cumulative.back( ); }
+
+        /// The smallest potentially generated index
+        result_type (min)( ) const { return 0; }
+
+        /// The largest potentially generated index
+        result_type (max)( ) const { return m_last; }
+
+        /// Draws are independent, nothing to reset
+        void reset( ) { }
+    private:
+        void build( ) {
+            assert( !m_cumulative.empty( ) );
+            RealType sum = 0;
+            for( std::size_t i = 0; i < m_cumulative.size( ); ++i ) {
+                if( m_cumulative[ i ] > RealType( 0 ) ) m_last = i;
+                sum += m_cumulative[ i ];
+                m_cumulative[ i ] = sum;
+            }
+            assert( sum > RealType( 0 ) ); // total weight should be positive
+
+            m_guide.reserve( m_cumulative.size( ) );
+            details::guide_build( m_cumulative.data( ), m_last, m_cumulative.size( ),
+                [ this ]( std::size_t index ) { m_guide.push_back( index ); } );
+        }
+    private:
+        std::vector<RealType> m_cumulative;
+        std::vector<std::size_t> m_guide;
+        std::size_t m_last = 0; // last index with positive weight
+    };
+
+    /**
+    * \brief Discrete distribution over indices [0; size) with
+    *        weights which can be updated between draws
+    * \note Partial sums are kept in a 16-ary tree stored level by level.
+    *       The 16 sums of a node are contiguous, so a draw or an update
+    *       reads about log16(size) nodes instead of log2(size) scattered
+    *       cache lines of a binary or Fenwick tree
+    * \note Draws and updates cost O(log(size))
+    * \param RealType The type of the weights and their sums
+    */
+    template<typename RealType = double>
+    class weight_tree {
+        static_assert( details::is_uniform_real<RealType>::value,
+                       "RealType should be float, double or long double" );
+    public:
+        /// Type of generated indices
+        using result_type = std::size_t;
+
+        /// Number of children of every tree node
+        static constexpr std::size_t fanout = 16;
+
+        /// Build the tree of 'size' zero weights
+        explicit weight_tree( std::size_t size ) {
+            assert( 0u != size );
+            m_levels.push_back( std::vector<RealType>( padded( size ) ) );
+            m_size = size;
+            build( );
+        }
+
+        /// Build the tree from weights in [first, last) range
+        template<typename InputIt>
+        weight_tree( InputIt first, InputIt last ) {
+            std::vector<RealType> leaves;
+            for( ; first != last; ++first ) {
+                assert( RealType( *first ) >= RealType( 0 ) );
+                leaves.push_back( RealType( *first ) );
+            }
+            assert( !leaves.empty( ) );
+            m_size = leaves.size( );
+            leaves.resize( padded( m_size ) );
+            m_levels.push_back( std::move( leaves ) );
+            build( );
+        }
+
+        /// Build the tree from weights in initializer_list
+        weight_tree( std::initializer_list<RealType> weights )
+            : weight_tree( weights.begin( ), weights.end( ) ) { }
+
+        /**
+        * \brief Return random index by internal uniform number from 'engine'
+        * \note Total weight should be positive
+        */
+        template<typename Engine>
+        result_type operator()( Engine& engine ) const {
+            return quantile( details::canonical<RealType>( engine ) );
+        }
+
+        /**
+        * \brief Return index for a given uniform number
+        * \param u A number in [0; 1) range
+        * \return The smallest index whose cumulative weight exceeds u * total
+        * \note Total weight should be positive
+        */
+        result_type quantile( RealType u ) const {
+            assert( 0 <= u && 1 > u ); // out of [0; 1) range
+            assert( total( ) > RealType( 0 ) ); // total weight should be positive
+            RealType value = u * total( );
+
+            std::size_t index = 0;
+            for( std::size_t level = m_levels.size( ); level-- > 0; ) {
+                const RealType* node = m_levels[ level ].data( ) + index * fanout;
+
+                // Rounding could leave 'value' past the node sum,
+                // then the last positive child is the answer
+                std::size_t child = fanout;
+                std::size_t last_positive = 0;
+                for( std::size_t i = 0; i < fanout; ++i ) {
+                    if( !( node[ i ] > RealType( 0 ) ) ) continue;
+                    last_positive = i;
+                    if( value < node[ i ] ) { child = i; break; }
+                    value -= node[ i ];
+                }
+                if( fanout == child ) {
+                    child = last_positive;
+                    value = node[ child ];
+                }
+                index = index * fanout + child;
+            }
+            return index;
+        }
+
+        /**
+        * \brief Change weight of the element at 'index'
+        * \note Recomputes one node per level: O(log(size))
+        */
+        void set( std::size_t index, RealType weight ) {
+            assert( index < m_size );
+            assert( weight >= RealType( 0 ) );
+            m_levels.front( )[ index ] = weight;
+            for( std::size_t level = 1; level < m_levels.size( ); ++level ) {
+                const std::size_t group = index / fanout;
+                m_levels[ level ][ group ] = node_sum( m_levels[ level - 1 ], group );
+                index = group;
+            }
+            m_total = node_sum( m_levels.back( ), 0 );
+        }
+
+        /// Return weight of the element at 'index'
+        RealType weight( std::size_t index ) const {
+            assert( index < m_size );
+            return m_levels.front( )[ index ];
+        }
+
+        /// Number of weights
+        std::size_t size( ) const { return m_size; }
+
+        /// Sum of all weights
+        RealType total( ) const { return m_total; }
+
+        /// The smallest potentially generated index
+        result_type (min)( ) const { return 0; }
+
+        /// The largest potentially generated index
+        result_type (max)( ) const { return m_size - 1; }
+
+        /// Draws are independent, nothing to reset
+        void reset( ) { }
+    private:
+        /// Round 'count' up to whole nodes
+        static std::size_t padded( std::size_t count ) {
+            return ( count + fanout - 1 ) / fanout * fanout;
+        }
+
+        /// Sum of the children of node 'group'
+        static RealType node_sum( const std::vector<RealType>& level, std::size_t group ) {
+            const RealType* node = level.data( ) + group * fanout;
+            RealType sum = 0;
+            for( std::size_t i = 0; i < fanout; ++i )
+                sum += node[ i ];
+            return sum;
+        }
+
+        /// Build upper levels until a single node remains on top
+        void build( ) {
+            while( m_levels.back( ).size( ) > fanout ) {
+                const std::vector<RealType>& below = m_levels.back( );
+                std::vector<RealType> level( padded( below.size( ) / fanout ) );
+                for( std::size_t group = 0; group < below.size( ) / fanout; ++group )
+                    level[ group ] = node_sum( below, group );
+                m_levels.push_back( std::move( level ) );
+            }
+            m_total = node_sum( m_levels.back( ), 0 );
+        }
+    private:
+        std::vector<std::vector<RealType>> m_levels; // leaves first
+        std::size_t m_size = 0;
+        RealType m_total = 0;
+    };
+
+    /**
+    * \brief Pseudorandom permutation of [0; size) in O(1) memory
+    * \note Indices are mixed by a balanced keyed Feistel network over the
+    *       smallest even number of bits covering 'size'. Values outside of
+    *       [0; size) are encrypted again (cycle-walking), which takes
+    *       less than 4 rounds of the network on average
+    * \note The same size and seed give the same permutation on any platform
+    */
+    class random_permutation {
+    public:
+        /// Type of permuted values
+        using result_type = std::uint64_t;
+
+        /// Number of Feistel rounds
+        static constexpr std::size_t rounds = 6;
+
+        /// Iterator over the permuted values, computed on dereference
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::uint64_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const value_type*;
+            using reference = value_type;
+
+            iterator( ) = default;
+
+            iterator( const random_permutation* parent, std::uint64_t index )
+                : m_permutation{ parent }, m_index{ index } { }
+
+            value_type operator*( ) const { return ( *m_permutation )[ m_index ]; }
+
+            iterator& operator++( ) {
+                ++m_index;
+                return *this;
+            }
+
+            iterator operator++( int ) {
+                iterator previous = *this;
+                ++m_index;
+                return previous;
+            }
+
+            friend bool operator==( const iterator& lhs, const iterator& rhs ) {
+                return lhs.m_index == rhs.m_index;
+            }
+
+            friend bool operator!=( const iterator& lhs, const iterator& rhs ) {
+                return lhs.m_index != rhs.m_index;
+            }
+        private:
+            const random_permutation* m_permutation = nullptr;
+            std::uint64_t m_index = 0;
+        };
+
+        /**
+        * \brief Build permutation of [0; size) keyed by 'seed'
+        * \param size The number of permuted values
+        * \param seed The key of the permutation
+        */
+        random_permutation( std::uint64_t size, std::uint64_t seed ) : m_size{ size } {
+            while( m_half < 32 && ( std::uint64_t{ 1 } << ( 2 * m_half ) ) < size )
+                ++m_half;
+            m_mask = ( std::uint64_t{ 1 } << m_half ) - 1;
+            for( auto& key : m_keys )
+                key = splitmix( seed += 0x9E3779B97F4A7C15ull );
+        }
+
+        /// Return value at 'index' position of the permutation, index < size( )
+        std::uint64_t operator[]( std::uint64_t index ) const {
+            assert( index < m_size );
+            do {
+                index = encrypt( index );
+            } while( index >= m_size );
+            return index;
+        }
+
+        /// Iterator to the first value
+        iterator begin( ) const { return iterator{ this, 0 }; }
+
+        /// Iterator past the last value
+        iterator end( ) const { return iterator{ this, m_size }; }
+
+        /// Return the number of permuted values
+        std::uint64_t size( ) const { return m_size; }
+    private:
+        /// SplitMix64 finalizer
+        static std::uint64_t splitmix( std::uint64_t value ) {
+            value = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+            value = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBull;
+            return value ^ ( value >> 31 );
+        }
+
+        /// One pass of the Feistel network over 2 * m_half bits
+        std::uint64_t encrypt( std::uint64_t value ) const {
+            std::uint64_t left = value >> m_half, right = value & m_mask;
+            for( const std::uint64_t key : m_keys ) {
+                const std::uint64_t mixed = left ^ ( splitmix( right ^ key ) & m_mask );
+                left = right;
+                right = mixed;
+            }
+            return left << m_half | right;
+        }
+    private:
+        std::uint64_t m_keys[ rounds ];
+        std::uint64_t m_size;
+        std::uint64_t m_mask = 0;
+        unsigned m_half = 1; // bits in each half of the network
     };
 
     /**
@@ -217,6 +2259,9 @@ namespace effolkronium {
         /// Key type for weighted random number generation
         using weight = details::weight;
 
+        /// Key type for cache-aware bucketed shuffle
+        using bucketed = details::bucketed;
+
         /**
         * \return The minimum value
         * potentially generated by the random-number engine
@@ -452,14 +2497,15 @@ namespace effolkronium {
         * \param first, last - the range of elements
         * \return Random iterator from [first, last) range
         * \note If first == last, return last
+        * \note Ranges without random access are traversed only once,
+        *       by reservoir sampling
         */
         template<typename InputIt>
         static typename std::enable_if<details::is_iterator<InputIt>::value
             , InputIt>::type get( InputIt first, InputIt last ) {
-            const auto size = std::distance( first, last );
-            if( 0 == size ) return last;
             using diff_t = typename std::iterator_traits<InputIt>::difference_type;
-            return std::next( first, get<diff_t>( 0, size - 1 ) );
+            return details::random_iterator<IntegerDist<diff_t>>( first, last, engine_instance( ),
+                typename std::iterator_traits<InputIt>::iterator_category{ } );
         }
 
         /**
@@ -492,8 +2538,8 @@ namespace effolkronium {
             Container<A> container;
 
             container.reserve(size);
-            for (std::size_t i = 0; i < size; ++i)
-                container.insert(std::end(container), get(from, to));
+            details::range_generator<A, IntegerDist, RealDist> generator{ from, to };
+            details::generate_into(generator, engine_instance( ), container, size);
 
             return container;
         }
@@ -518,11 +2564,15 @@ namespace effolkronium {
                    std::is_same<Key, common>::value
                 && details::has_reserve<Container<A>>::value
             , Container<C>>::type get(A start, B end, std::size_t size) {
+            // Prevent implicit type conversion from signed to unsigned types
+            static_assert(std::is_signed<A>::value != std::is_unsigned<B>::value,
+                "Prevent implicit type conversion from signed to unsigned types");
             Container<C> container;
 
             container.reserve(size);
-            for (std::size_t i = 0; i < size; ++i)
-                container.insert(std::end(container), get<common>(start, end));
+            details::range_generator<C, IntegerDist, RealDist> generator{
+                static_cast<C>(start), static_cast<C>(end) };
+            details::generate_into(generator, engine_instance( ), container, size);
 
             return container;
         }
@@ -540,8 +2590,8 @@ namespace effolkronium {
             , Container<A>>::type get(A start, A end, std::size_t size) {
             Container<A> container;
 
-            for (std::size_t i = 0; i < size; ++i)
-                container.insert(std::end(container), get(start, end));
+            details::range_generator<A, IntegerDist, RealDist> generator{ start, end };
+            details::generate_into(generator, engine_instance( ), container, size);
 
             return container;
         }
@@ -565,11 +2615,112 @@ namespace effolkronium {
                  std::is_same<Key, common>::value
               && !details::has_reserve<Container<C>>::value
             , Container<C>>::type get(A start, B end, std::size_t size) {
+            // Prevent implicit type conversion from signed to unsigned types
+            static_assert(std::is_signed<A>::value != std::is_unsigned<B>::value,
+                "Prevent implicit type conversion from signed to unsigned types");
             Container<C> container;
 
-            for (std::size_t i = 0; i < size; ++i)
-                container.insert(std::end(container), get<common>(start, end));
+            details::range_generator<C, IntegerDist, RealDist> generator{
+                static_cast<C>(start), static_cast<C>(end) };
+            details::generate_into(generator, engine_instance( ), container, size);
+
+            return container;
+        }
+
+        /**
+        * \brief Return container filled with random values,
+        *        using the given allocator
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param size The number of elements in resulting container
+        * \param alloc The allocator copied into the resulting container
+        * \return Container filled with random values
+        * \note Contiguous containers are resized once and written in bulk
+        */
+        template<template<typename...> class Container, typename A>
+        static Container<A> get( A from, A to, std::size_t size,
+                         const typename Container<A>::allocator_type& alloc ) {
+            Container<A> container( alloc );
+
+            details::try_reserve( container, size );
+            details::range_generator<A, IntegerDist, RealDist> generator{ from, to };
+            details::generate_into( generator, engine_instance( ), container, size );
+
+            return container;
+        }
+
+        /**
+        * \brief Return container filled with random common_type values,
+        *        using the given allocator
+        * \param Key The Key type for this version of 'get' method
+        *     Type should be '(THIS_TYPE)::common' struct
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param size The number of elements in resulting container
+        * \param alloc The allocator copied into the resulting container
+        * \return Container filled with random values
+        */
+        template<
+            template<typename...> class Container,
+            typename Key,
+            typename A,
+            typename B,
+            typename C = typename std::common_type<A, B>::type>
+        static typename std::enable_if<
+                 std::is_same<Key, common>::value
+            , Container<C>>::type get( A start, B end, std::size_t size,
+                         const typename Container<C>::allocator_type& alloc ) {
+            // Prevent implicit type conversion from signed to unsigned types
+            static_assert(std::is_signed<A>::value != std::is_unsigned<B>::value,
+                "Prevent implicit type conversion from signed to unsigned types");
+            Container<C> container( alloc );
+
+            details::try_reserve( container, size );
+            details::range_generator<C, IntegerDist, RealDist> generator{
+                static_cast<C>(start), static_cast<C>(end) };
+            details::generate_into( generator, engine_instance( ), container, size );
+
+            return container;
+        }
+
+        /**
+        * \brief Return container filled with 'size' distinct random
+        *        integers in a [from; to] range
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param size The number of elements in resulting container,
+        *        at most the number of integers in the range
+        * \return Container filled with distinct random values
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Floyd's algorithm: time and memory are O(size)
+        *       whatever the width of the range. The values are shuffled
+        *       afterwards, so their order is uniformly random too
+        * \throw std::invalid_argument if the range has fewer than 'size' integers
+        */
+        template<template<typename...> class Container, typename A>
+        static typename std::enable_if<
+               details::is_uniform_int<A>::value
+            , Container<A>>::type get_unique( A from, A to, std::size_t size ) {
+            using unsigned_t = typename std::make_unsigned<A>::type;
+            if( from > to )
+                std::swap( from, to );
+            const std::uint64_t span = static_cast<std::uint64_t>(
+                static_cast<unsigned_t>( static_cast<unsigned_t>( to ) - static_cast<unsigned_t>( from ) ) );
+
+            std::vector<A> values;
+            values.reserve( size );
+            details::unique_offsets<IntegerDist<std::uint64_t>>( engine_instance( ), span, size,
+                [ &values, from ]( std::uint64_t offset ) {
+                    values.push_back( static_cast<A>( static_cast<unsigned_t>(
+                        static_cast<unsigned_t>( from ) + static_cast<unsigned_t>( offset ) ) ) );
+                } );
+            // Floyd's algorithm yields later values closer to 'to'
+            details::shuffle( values.begin( ), values.end( ), engine_instance( ) );
 
+            Container<A> container;
+            details::try_reserve( container, size );
+            for( const A value : values )
+                container.insert( std::end( container ), value );
             return container;
         }
 
@@ -584,10 +2735,10 @@ namespace effolkronium {
         static typename std::enable_if<
                !details::has_insert<Container<A, N>>::value
             , Container<A, N>>::type get(A start, A end) {
-            Container<A, N> container = {{ 0 }};
+            Container<A, N> container;
 
-            for (std::size_t i = 0; i < N; ++i)
-                container[i] = get(start, end);
+            details::range_generator<A, IntegerDist, RealDist> generator{ start, end };
+            details::generate_array<N>(generator, engine_instance( ), container);
 
             return container;
         }
@@ -612,14 +2763,279 @@ namespace effolkronium {
                   std::is_same<Key, common>::value
                && !details::has_insert<Container<C, N>>::value
             , Container<C, N>>::type get(A start, B end) {
-            Container<C, N> container = {{ 0 }};
+            // Prevent implicit type conversion from signed to unsigned types
+            static_assert(std::is_signed<A>::value != std::is_unsigned<B>::value,
+                "Prevent implicit type conversion from signed to unsigned types");
+            Container<C, N> container;
 
-            for (std::size_t i = 0; i < N; ++i)
-                container[i] = get<common>(start, end);
+            details::range_generator<C, IntegerDist, RealDist> generator{
+                static_cast<C>(start), static_cast<C>(end) };
+            details::generate_array<N>(generator, engine_instance( ), container);
 
             return container;
         }
 
+        /**
+        * \brief Fill [first, last) range with random values in a [from; to] range
+        * \param first, last - the range of elements to fill
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note The distribution is built once for the whole range
+        *       and nothing is allocated
+        */
+        template<typename ForwardIt, typename T>
+        static typename std::enable_if<
+               details::is_iterator<ForwardIt>::value
+            && details::is_range_type<T>::value
+            >::type fill( ForwardIt first, ForwardIt last, T from, T to ) {
+            details::range_generator<T, IntegerDist, RealDist> generator{ from, to };
+            details::generate( generator, engine_instance( ), first, last );
+        }
+
+        /**
+        * \brief Fill 'size' elements from 'data' pointer
+        *        with random values in a [from; to] range
+        * \param data Pointer to the first element to fill
+        * \param size The number of elements to fill
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        */
+        template<typename T>
+        static typename std::enable_if<details::is_range_type<T>::value
+            >::type fill( T* data, std::size_t size, T from, T to ) {
+            details::range_generator<T, IntegerDist, RealDist> generator{ from, to };
+            details::generate_n( generator, engine_instance( ), data, size );
+        }
+
+        /**
+        * \brief Fill all elements of container or span
+        *        with random values in a [from; to] range
+        * \param container The container with elements to fill
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        */
+        template<typename Container, typename T>
+        static auto fill( Container&& container, T from, T to ) ->
+            typename std::enable_if<details::is_iterator<
+                decltype(std::begin(container))>::value
+                && details::is_range_type<T>::value
+            >::type {
+            fill( std::begin( container ), std::end( container ), from, to );
+        }
+
+        /**
+        * \brief Return lazy infinite range of random values in a [from; to] range
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \return Input range, std::ranges::view when ranges are available
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Values are generated in blocks, the view keeps a reference
+        *       to the internal engine and must not outlive it
+        */
+        template<typename T>
+        static typename std::enable_if<details::is_range_type<T>::value
+            , details::random_view<details::range_generator<T, IntegerDist, RealDist>, Engine>
+            >::type view( T from, T to ) {
+            return { details::range_generator<T, IntegerDist, RealDist>{ from, to }, engine_instance( ) };
+        }
+
+        /**
+        * \brief Return lazy range of 'count' random values in a [from; to] range
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param count The number of values in the range
+        * \return Input range, std::ranges::view when ranges are available
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Values are generated in blocks, the view keeps a reference
+        *       to the internal engine and must not outlive it
+        */
+        template<typename T>
+        static typename std::enable_if<details::is_range_type<T>::value
+            , details::random_view<details::range_generator<T, IntegerDist, RealDist>, Engine>
+            >::type view( T from, T to, std::size_t count ) {
+            return { details::range_generator<T, IntegerDist, RealDist>{ from, to }, engine_instance( ), count };
+        }
+
+        /**
+        * \brief Fill [first, last) range with normally distributed random values
+        * \param first, last - the range of elements to fill
+        * \param mean The mean of the distribution
+        * \param stddev The standard deviation of the distribution, should be positive
+        * \note Values are generated in blocks by Box-Muller transform,
+        *       both values of every pair are used
+        */
+        template<typename ForwardIt, typename T>
+        static typename std::enable_if<
+               details::is_iterator<ForwardIt>::value
+            && std::is_floating_point<T>::value
+            >::type fill_normal( ForwardIt first, ForwardIt last, T mean, T stddev ) {
+            details::normal_generator<T, IntegerDist, RealDist> generator{ mean, stddev };
+            details::generate( generator, engine_instance( ), first, last );
+        }
+
+        /**
+        * \brief Fill all elements of container or span
+        *        with normally distributed random values
+        * \param container The container with elements to fill
+        * \param mean The mean of the distribution
+        * \param stddev The standard deviation of the distribution, should be positive
+        */
+        template<typename Container, typename T>
+        static auto fill_normal( Container&& container, T mean, T stddev ) ->
+            typename std::enable_if<details::is_iterator<
+                decltype(std::begin(container))>::value
+                && std::is_floating_point<T>::value
+            >::type {
+            fill_normal( std::begin( container ), std::end( container ), mean, stddev );
+        }
+
+        /**
+        * \brief Fill bits of 'words' by independent random bits
+        *        which are set with probability 'p'
+        * \param words The array of at least (nbits + 63) / 64 words
+        * \param nbits The number of bits to fill, bit i is bit (i % 64) of words[ i / 64 ]
+        * \param p The probability of a set bit in a [0; 1] range
+        * \note Bits past 'nbits' in the last word are cleared
+        * \note Sparse (p < 1/8) and dense (p > 7/8) bits are placed by geometric
+        *       skipping, at a cost proportional to the number of set or clear bits.
+        *       Other probabilities are rounded to 32 binary digits and
+        *       produced a word at a time
+        */
+        static void fill_bernoulli_bits( std::uint64_t* words, std::size_t nbits, double p ) {
+            assert( 0. <= p && 1. >= p ); // out of [0; 1] range
+            details::bernoulli_bits( engine_instance( ), words, nbits, p );
+        }
+
+        /**
+        * \brief Return bitset of 'size' independent random bits
+        *        which are set with probability 'p'
+        * \param size The number of bits
+        * \param p The probability of a set bit in a [0; 1] range
+        * \return Vector of (size + 63) / 64 words, bit i is bit (i % 64) of word i / 64
+        */
+        static std::vector<std::uint64_t> random_bitset( std::size_t size, double p ) {
+            std::vector<std::uint64_t> words( ( size + 63 ) / 64 );
+            fill_bernoulli_bits( words.data( ), size, p );
+            return words;
+        }
+
+        /**
+        * \brief Write 'size' stratified random values in a [0; 1) range to 'out'
+        * \param size The number of values and strata
+        * \param out The beginning of the destination range of floating point values
+        * \return Iterator past the last written value
+        * \note Value i is uniform in [i / size; (i + 1) / size),
+        *       values are written in ascending order of strata
+        */
+        template<typename ForwardIt>
+        static typename std::enable_if<
+            std::is_floating_point<typename std::iterator_traits<ForwardIt>::value_type>::value
+            , ForwardIt>::type stratified_uniform( std::size_t size, ForwardIt out ) {
+            details::range_generator<typename std::iterator_traits<ForwardIt>::value_type,
+                                     IntegerDist, RealDist> uniform{ 0, 1 };
+            return details::stratified_fill( uniform, engine_instance( ), out, size );
+        }
+
+        /**
+        * \brief Write Latin hypercube design of 'size' random points
+        *        in a [0; 1)^dims cube to 'out'
+        * \param size The number of points
+        * \param dims The number of dimensions
+        * \param out The beginning of the destination range of size * dims
+        *        floating point values
+        * \return Iterator past the last written value
+        * \note The layout is structure of arrays: coordinate d of point i
+        *       is at out[ d * size + i ]
+        * \note Each of the 'size' equal strata of every dimension
+        *       holds exactly one point
+        */
+        template<typename RandomIt>
+        static typename std::enable_if<
+            std::is_floating_point<typename std::iterator_traits<RandomIt>::value_type>::value
+            , RandomIt>::type latin_hypercube( std::size_t size, std::size_t dims, RandomIt out ) {
+            details::range_generator<typename std::iterator_traits<RandomIt>::value_type,
+                                     IntegerDist, RealDist> uniform{ 0, 1 };
+            return details::latin_hypercube( uniform, engine_instance( ), size, dims, out );
+        }
+
+        /**
+        * \brief Write 'size' random bytes to memory at 'data'
+        * \param data Pointer to the first byte to write
+        * \param size The number of bytes to write
+        * \note Raw engine words are copied straight to the memory if
+        *       the engine produces full 32 or 64-bit words,
+        *       otherwise every byte is drawn by IntegerDist
+        */
+        static void get_bytes( void* data, std::size_t size ) {
+            details::random_bytes<IntegerDist<unsigned short>>( engine_instance( ),
+                static_cast<unsigned char*>( data ), size );
+        }
+
+        /**
+        * \brief Fill [first, last) range of bytes with random bytes
+        * \param first, last - the range of char, signed char,
+        *        unsigned char or std::byte elements
+        * \note Contiguous ranges of pointers are filled like by 'get_bytes'
+        */
+        template<typename ForwardIt>
+        static typename std::enable_if<
+               details::is_iterator<ForwardIt>::value
+            && details::is_byte_storage<
+                   typename std::iterator_traits<ForwardIt>::value_type>::value
+            >::type fill_bytes( ForwardIt first, ForwardIt last ) {
+            details::random_bytes<IntegerDist<unsigned short>>( engine_instance( ), first, last );
+        }
+
+        /**
+        * \brief Write 'size' random values in a [from; to] range to 'out'
+        * \param out The output iterator, like std::back_inserter
+        *        or std::ostream_iterator
+        * \param size The number of values to write
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \return Output iterator past the last written value
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Values are generated in blocks by the bulk kernels
+        */
+        template<typename OutputIt, typename T>
+        static typename std::enable_if<details::is_range_type<T>::value
+            , OutputIt>::type generate_n( OutputIt out, std::size_t size, T from, T to ) {
+            details::range_generator<T, IntegerDist, RealDist> generator{ from, to };
+            return details::generate_n( generator, engine_instance( ), out, size );
+        }
+
+        /**
+        * \brief Write 'size' random common_type values in a [from; to] range to 'out'
+        * \param Key The Key type for this version of 'generate_n' method
+        *        Type should be '(THIS_TYPE)::common' struct
+        * \param out The output iterator
+        * \param size The number of values to write
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \return Output iterator past the last written value
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Prevent implicit type conversion from signed to unsigned types
+        */
+        template<
+            typename Key,
+            typename OutputIt,
+            typename A,
+            typename B,
+            typename C = typename std::common_type<A, B>::type
+        >
+        static typename std::enable_if<
+               std::is_same<Key, common>::value
+            && details::is_supported_number<A>::value
+            && details::is_supported_number<B>::value
+            // Prevent implicit type conversion from signed to unsigned types
+            && std::is_signed<A>::value != std::is_unsigned<B>::value
+            , OutputIt>::type generate_n( OutputIt out, std::size_t size, A from, B to ) {
+            return generate_n( out, size, static_cast<C>( from ), static_cast<C>( to ) );
+        }
+
         /**
         * \brief Return random pointer from built-in array
         * \param array The built-in array with elements
@@ -737,15 +3153,82 @@ namespace effolkronium {
             return std::end(map_container);
         }
 
+        /**
+        * \brief Return a random iterator from given contiguous container
+        *        by utilizing its real values as weights
+        *        for weighted random number generation
+        * \param Key The Key type for this version of 'get' method
+        *        Type should be '(THIS_TYPE)::weight' struct
+        * \param weights A contiguous container of non-negative real weights,
+        *        like std::vector<double> or std::array<float, N>
+        * \note return the end iterator if the container is empty or total weight is zero
+        * \note The weights are summed and searched block by block,
+        *       the sum vectorizes, the search skips a block per lane sum
+        */
+        template<
+            typename Key,
+            class Container
+        >
+        static auto get(const Container& weights) -> typename std::enable_if<
+            !details::is_map<Container>::value &&
+            details::is_contiguous<Container>::value &&
+            details::is_uniform_real<typename Container::value_type>::value &&
+            std::is_same<Key, details::weight>::value,
+        decltype(std::begin(weights))>::type {
+            using ValueType = typename Container::value_type;
+            using DiffType = typename std::iterator_traits<decltype(std::begin(weights))>::difference_type;
+
+            const ValueType* data = weights.data( );
+            const std::size_t size = weights.size( );
+            assert(std::all_of(data, data + size,
+                [](ValueType value) { return value >= ValueType(0); }));
+
+            const ValueType total_weight = details::weight_sum(data, size);
+            if(!(total_weight > ValueType(0))) return std::end(weights);
+
+            ValueType random_weight = get(ValueType(0), std::nextafter(total_weight, (std::numeric_limits<ValueType>::min)( )));
+            return std::next(std::begin(weights),
+                static_cast<DiffType>(details::weight_search(data, size, random_weight)));
+        }
+
+        /**
+        * \brief Write 'count' random iterators from given weighted container
+        *        to 'out', built from a single pass over the weights
+        * \param Key The Key type for this version of 'get' method
+        *        Type should be '(THIS_TYPE)::weight' struct
+        * \param container A map-like container with unsigned integer or real
+        *        mapped values, or a contiguous container of real weights
+        * \param count The number of weighted random selections
+        * \param out The output iterator receiving container iterators
+        * \return Output iterator past the last written element
+        * \note Costs O(count + size) instead of O(count * size) of repeated calls
+        * \note Selections are written in container order, nothing is written
+        *       if the container is empty or total weight is zero
+        */
+        template<
+            typename Key,
+            class Container,
+            class OutputIt
+        >
+        static auto get(const Container& container, std::size_t count, OutputIt out) -> typename std::enable_if<
+            details::is_weight<typename details::weight_type<Container>::type>::value &&
+            std::is_same<Key, details::weight>::value,
+        OutputIt>::type {
+            return details::weighted_draws(engine_instance( ), container, count, out);
+        }
+
         /**
         * \brief Reorders the elements in the given range [first, last)
         *        such that each possible permutation of those elements
         *        has equal probability of appearance.
         * \param first, last - the range of elements to shuffle randomly       
+        * \note Fisher-Yates shuffle which takes several indices from every
+        *       64-bit engine word, engines without full 32 or 64-bit output
+        *       are passed to std::shuffle
         */
         template<typename RandomIt>
         static void shuffle( RandomIt first, RandomIt last ) {
-            std::shuffle( first, last, engine_instance( ) );
+            details::shuffle( first, last, engine_instance( ) );
         }
 
         /**
@@ -758,6 +3241,180 @@ namespace effolkronium {
         static void shuffle( Container& container ) {
             shuffle( std::begin( container ), std::end( container ) );
         }
+
+        /**
+        * \brief Reorders the elements in the given range [first, last)
+        *        such that each possible permutation of those elements
+        *        has equal probability of appearance, with cache-aware buckets
+        * \param Key The Key type for this version of 'shuffle' method
+        *     Type should be '(THIS_TYPE)::bucketed' struct
+        * \param first, last - the random-access range of elements to shuffle randomly
+        * \note Elements are scattered to cache-sized random buckets, which
+        *       are shuffled one by one. Ranges much larger than the last-level
+        *       cache are shuffled with far fewer cache misses, at the cost of
+        *       a temporary copy of the range
+        */
+        template<typename Key, typename RandomIt>
+        static typename std::enable_if<
+            std::is_same<Key, bucketed>::value
+            >::type shuffle( RandomIt first, RandomIt last ) {
+            details::bucketed_shuffle( first, last, engine_instance( ) );
+        }
+
+        /**
+        * \brief Reorders the elements in the given container
+        *        such that each possible permutation of those elements
+        *        has equal probability of appearance, with cache-aware buckets
+        * \param Key The Key type for this version of 'shuffle' method
+        *     Type should be '(THIS_TYPE)::bucketed' struct
+        * \param container - the container with elements to shuffle randomly
+        */
+        template<typename Key, typename Container>
+        static typename std::enable_if<
+            std::is_same<Key, bucketed>::value
+            >::type shuffle( Container& container ) {
+            shuffle<Key>( std::begin( container ), std::end( container ) );
+        }
+
+        /**
+        * \brief Moves k random elements of the range [first, last)
+        *        to its beginning, in random order. Each possible
+        *        k-permutation has equal probability of appearance.
+        * \param first, last - the random-access range of elements
+        * \param k The number of elements to select, at most the range size
+        * \return Iterator past the k-th element
+        * \note Only k Fisher-Yates steps are done, so it costs O(k)
+        */
+        template<typename RandomIt>
+        static typename std::enable_if<
+            std::is_base_of<std::random_access_iterator_tag,
+                typename std::iterator_traits<RandomIt>::iterator_category>::value
+            , RandomIt>::type partial_shuffle( RandomIt first, RandomIt last, std::size_t k ) {
+            return details::partial_shuffle( first, last, k, engine_instance( ) );
+        }
+
+        /**
+        * \brief Moves k random elements of the container
+        *        to its beginning, in random order
+        * \param container - the container with elements to select
+        * \param k The number of elements to select, at most the container size
+        * \return Iterator past the k-th element
+        */
+        template<typename Container>
+        static auto partial_shuffle( Container& container, std::size_t k )
+            -> decltype( std::begin( container ) ) {
+            return partial_shuffle( std::begin( container ), std::end( container ), k );
+        }
+
+        /**
+        * \brief Copies k random elements of the range [first, last)
+        *        to 'out', in random order. Each possible
+        *        k-permutation has equal probability of appearance.
+        * \param first, last - the random-access range of elements
+        * \param k The number of elements to copy, at most the range size
+        * \param out The output iterator
+        * \return Output iterator past the last copied element
+        * \note The range is not modified, time and memory are O(k)
+        */
+        template<typename RandomIt, typename OutputIt>
+        static typename std::enable_if<
+            std::is_base_of<std::random_access_iterator_tag,
+                typename std::iterator_traits<RandomIt>::iterator_category>::value
+            , OutputIt>::type sample( RandomIt first, RandomIt last, std::size_t k, OutputIt out ) {
+            return details::sample( first, last, k, out, engine_instance( ) );
+        }
+
+        /**
+        * \brief Copies k random elements of the range [first, last)
+        *        to random-access 'out' in a single pass, in random order.
+        *        Each possible k-permutation has equal probability of appearance.
+        * \param first, last - the input or forward range of elements
+        * \param k The number of elements to copy
+        * \param out The random-access output iterator to at least k elements
+        * \return Output iterator past the last copied element,
+        *         less than k elements are copied from short ranges
+        * \note Reservoir sampling by Algorithm L: the range is traversed once
+        *       and only O(k log(n / k)) random numbers are drawn
+        */
+        template<typename InputIt, typename RandomOut>
+        static typename std::enable_if<
+               details::is_iterator<InputIt>::value
+            && !std::is_base_of<std::random_access_iterator_tag,
+                   typename std::iterator_traits<InputIt>::iterator_category>::value
+            && std::is_base_of<std::random_access_iterator_tag,
+                   typename std::iterator_traits<RandomOut>::iterator_category>::value
+            , RandomOut>::type sample( InputIt first, InputIt last, std::size_t k, RandomOut out ) {
+            return details::reservoir_sample<IntegerDist<std::size_t>>( first, last, k, out, engine_instance( ) );
+        }
+
+        /**
+        * \brief Return vector of k random elements of the range [first, last),
+        *        in random order
+        * \param first, last - the range of elements, input iterators are
+        *        traversed once by reservoir sampling
+        * \param k The number of elements to select
+        * \return Vector of selected elements,
+        *         less than k elements for short ranges
+        */
+        template<typename InputIt>
+        static typename std::enable_if<details::is_iterator<InputIt>::value
+            , std::vector<typename std::iterator_traits<InputIt>::value_type>
+            >::type sample( InputIt first, InputIt last, std::size_t k ) {
+            return details::sample_vector<IntegerDist<std::size_t>>( first, last, k, engine_instance( ),
+                typename std::iterator_traits<InputIt>::iterator_category{ } );
+        }
+
+        /**
+        * \brief Return pseudorandom permutation of [0; size)
+        *        keyed by a seed from the internal engine
+        * \param size The number of permuted values
+        * \return Permutation with random access and iteration in O(1) memory
+        */
+        static random_permutation permutation( std::uint64_t size ) {
+            return random_permutation{ size, details::next_wide_word( engine_instance( ) ) };
+        }
+
+        /**
+        * \brief Return pseudorandom permutation of [0; size) keyed by 'seed'
+        * \param size The number of permuted values
+        * \param seed The key of the permutation
+        * \return Permutation with random access and iteration in O(1) memory
+        * \note The internal engine is not used
+        */
+        static random_permutation permutation( std::uint64_t size, std::uint64_t seed ) {
+            return random_permutation{ size, seed };
+        }
+
+        /**
+        * \brief Reorders the elements in the given range [first, last)
+        *        on several threads such that each possible permutation
+        *        of those elements has equal probability of appearance.
+        * \param first, last - the random-access range of elements to shuffle randomly
+        * \param threads The number of threads, 0 means std::thread::hardware_concurrency
+        * \note Blocks of the range are shuffled independently and merged
+        *       pairwise (MergeShuffle). The result depends only on the internal
+        *       engine state and never on the number of threads
+        * \note The internal engine is advanced by 4 calls regardless of the range size
+        */
+        template<typename RandomIt>
+        static typename std::enable_if<
+            std::is_base_of<std::random_access_iterator_tag,
+                typename std::iterator_traits<RandomIt>::iterator_category>::value
+            >::type parallel_shuffle( RandomIt first, RandomIt last, std::size_t threads = 0 ) {
+            details::parallel_shuffle( first, last, engine_instance( ), threads );
+        }
+
+        /**
+        * \brief Reorders the elements in the given container
+        *        on several threads such that each possible permutation
+        *        of those elements has equal probability of appearance.
+        * \param container - the container with elements to shuffle randomly
+        * \param threads The number of threads, 0 means std::thread::hardware_concurrency
+        */
+        template<typename Container>
+        static void parallel_shuffle( Container& container, std::size_t threads = 0 ) {
+            parallel_shuffle( std::begin( container ), std::end( container ), threads );
+        }
     private:
         static Engine& engine_instance( ) {
             return Derived::engine();
@@ -804,6 +3461,9 @@ namespace effolkronium {
         /// Key type for weighted random number generation
         using weight = details::weight;
 
+        /// Key type for cache-aware bucketed shuffle
+        using bucketed = details::bucketed;
+
         basic_random_static() = delete;
 
         /// return internal engine by copy
@@ -863,6 +3523,9 @@ namespace effolkronium {
         /// Key type for weighted random number generation
         using weight = details::weight;
 
+        /// Key type for cache-aware bucketed shuffle
+        using bucketed = details::bucketed;
+
         basic_random_thread_local( ) = delete;
 
         /// return internal engine by copy
@@ -922,6 +3585,9 @@ namespace effolkronium {
         /// Key type for weighted random number generation
         using weight = details::weight;
 
+        /// Key type for cache-aware bucketed shuffle
+        using bucketed = details::bucketed;
+
         /// Advances the internal state by z times
         void discard( const unsigned long long z ) {
             m_engine.discard( z );
@@ -1141,14 +3807,15 @@ namespace effolkronium {
         * \param first, last - the range of elements
         * \return Random iterator from [first, last) range
         * \note If first == last, return last
+        * \note Ranges without random access are traversed only once,
+        *       by reservoir sampling
         */
         template<typename InputIt>
         typename std::enable_if<details::is_iterator<InputIt>::value
             , InputIt>::type get( InputIt first, InputIt last ) {
-            const auto size = std::distance( first, last );
-            if( 0 == size ) return last;
             using diff_t = typename std::iterator_traits<InputIt>::difference_type;
-            return std::next( first, get<diff_t>( 0, size - 1 ) );
+            return details::random_iterator<IntegerDist<diff_t>>( first, last, m_engine,
+                typename std::iterator_traits<InputIt>::iterator_category{ } );
         }
 
         /**
@@ -1181,8 +3848,8 @@ namespace effolkronium {
             Container<A> container;
 
             container.reserve(size);
-            for (std::size_t i = 0; i < size; ++i)
-                container.insert(std::end(container), get(from, to));
+            details::range_generator<A, IntegerDist, RealDist> generator{ from, to };
+            details::generate_into(generator, m_engine, container, size);
 
             return container;
         }
@@ -1207,11 +3874,15 @@ namespace effolkronium {
                    std::is_same<Key, common>::value
                 && details::has_reserve<Container<A>>::value
             , Container<C>>::type get(A start, B end, std::size_t size) {
+            // Prevent implicit type conversion from signed to unsigned types
+            static_assert(std::is_signed<A>::value != std::is_unsigned<B>::value,
+                "Prevent implicit type conversion from signed to unsigned types");
             Container<C> container;
 
             container.reserve(size);
-            for (std::size_t i = 0; i < size; ++i)
-                container.insert(std::end(container), get<common>(start, end));
+            details::range_generator<C, IntegerDist, RealDist> generator{
+                static_cast<C>(start), static_cast<C>(end) };
+            details::generate_into(generator, m_engine, container, size);
 
             return container;
         }
@@ -1229,8 +3900,8 @@ namespace effolkronium {
             , Container<A>>::type get(A start, A end, std::size_t size) {
             Container<A> container;
 
-            for (std::size_t i = 0; i < size; ++i)
-                container.insert(std::end(container), get(start, end));
+            details::range_generator<A, IntegerDist, RealDist> generator{ start, end };
+            details::generate_into(generator, m_engine, container, size);
 
             return container;
         }
@@ -1254,11 +3925,112 @@ namespace effolkronium {
                  std::is_same<Key, common>::value
               && !details::has_reserve<Container<C>>::value
             , Container<C>>::type get(A start, B end, std::size_t size) {
+            // Prevent implicit type conversion from signed to unsigned types
+            static_assert(std::is_signed<A>::value != std::is_unsigned<B>::value,
+                "Prevent implicit type conversion from signed to unsigned types");
             Container<C> container;
 
-            for (std::size_t i = 0; i < size; ++i)
-                container.insert(std::end(container), get<common>(start, end));
+            details::range_generator<C, IntegerDist, RealDist> generator{
+                static_cast<C>(start), static_cast<C>(end) };
+            details::generate_into(generator, m_engine, container, size);
+
+            return container;
+        }
+
+        /**
+        * \brief Return container filled with random values,
+        *        using the given allocator
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param size The number of elements in resulting container
+        * \param alloc The allocator copied into the resulting container
+        * \return Container filled with random values
+        * \note Contiguous containers are resized once and written in bulk
+        */
+        template<template<typename...> class Container, typename A>
+        Container<A> get( A from, A to, std::size_t size,
+                         const typename Container<A>::allocator_type& alloc ) {
+            Container<A> container( alloc );
+
+            details::try_reserve( container, size );
+            details::range_generator<A, IntegerDist, RealDist> generator{ from, to };
+            details::generate_into( generator, m_engine, container, size );
+
+            return container;
+        }
+
+        /**
+        * \brief Return container filled with random common_type values,
+        *        using the given allocator
+        * \param Key The Key type for this version of 'get' method
+        *     Type should be '(THIS_TYPE)::common' struct
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param size The number of elements in resulting container
+        * \param alloc The allocator copied into the resulting container
+        * \return Container filled with random values
+        */
+        template<
+            template<typename...> class Container,
+            typename Key,
+            typename A,
+            typename B,
+            typename C = typename std::common_type<A, B>::type>
+        typename std::enable_if<
+                 std::is_same<Key, common>::value
+            , Container<C>>::type get( A start, B end, std::size_t size,
+                         const typename Container<C>::allocator_type& alloc ) {
+            // Prevent implicit type conversion from signed to unsigned types
+            static_assert(std::is_signed<A>::value != std::is_unsigned<B>::value,
+                "Prevent implicit type conversion from signed to unsigned types");
+            Container<C> container( alloc );
+
+            details::try_reserve( container, size );
+            details::range_generator<C, IntegerDist, RealDist> generator{
+                static_cast<C>(start), static_cast<C>(end) };
+            details::generate_into( generator, m_engine, container, size );
+
+            return container;
+        }
+
+        /**
+        * \brief Return container filled with 'size' distinct random
+        *        integers in a [from; to] range
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param size The number of elements in resulting container,
+        *        at most the number of integers in the range
+        * \return Container filled with distinct random values
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Floyd's algorithm: time and memory are O(size)
+        *       whatever the width of the range. The values are shuffled
+        *       afterwards, so their order is uniformly random too
+        * \throw std::invalid_argument if the range has fewer than 'size' integers
+        */
+        template<template<typename...> class Container, typename A>
+        typename std::enable_if<
+               details::is_uniform_int<A>::value
+            , Container<A>>::type get_unique( A from, A to, std::size_t size ) {
+            using unsigned_t = typename std::make_unsigned<A>::type;
+            if( from > to )
+                std::swap( from, to );
+            const std::uint64_t span = static_cast<std::uint64_t>(
+                static_cast<unsigned_t>( static_cast<unsigned_t>( to ) - static_cast<unsigned_t>( from ) ) );
+
+            std::vector<A> values;
+            values.reserve( size );
+            details::unique_offsets<IntegerDist<std::uint64_t>>( m_engine, span, size,
+                [ &values, from ]( std::uint64_t offset ) {
+                    values.push_back( static_cast<A>( static_cast<unsigned_t>(
+                        static_cast<unsigned_t>( from ) + static_cast<unsigned_t>( offset ) ) ) );
+                } );
+            // Floyd's algorithm yields later values closer to 'to'
+            details::shuffle( values.begin( ), values.end( ), m_engine );
 
+            Container<A> container;
+            details::try_reserve( container, size );
+            for( const A value : values )
+                container.insert( std::end( container ), value );
             return container;
         }
 
@@ -1273,10 +4045,10 @@ namespace effolkronium {
         typename std::enable_if<
                !details::has_insert<Container<A, N>>::value
             , Container<A, N>>::type get(A start, A end) {
-            Container<A, N> container = {{ 0 }};
+            Container<A, N> container;
 
-            for (std::size_t i = 0; i < N; ++i)
-                container[i] = get(start, end);
+            details::range_generator<A, IntegerDist, RealDist> generator{ start, end };
+            details::generate_array<N>(generator, m_engine, container);
 
             return container;
         }
@@ -1301,14 +4073,303 @@ namespace effolkronium {
                   std::is_same<Key, common>::value
                && !details::has_insert<Container<C, N>>::value
             , Container<C, N>>::type get(A start, B end) {
-            Container<C, N> container = {{ 0 }};
+            // Prevent implicit type conversion from signed to unsigned types
+            static_assert(std::is_signed<A>::value != std::is_unsigned<B>::value,
+                "Prevent implicit type conversion from signed to unsigned types");
+            Container<C, N> container;
 
-            for (std::size_t i = 0; i < N; ++i)
-                container[i] = get<common>(start, end);
+            details::range_generator<C, IntegerDist, RealDist> generator{
+                static_cast<C>(start), static_cast<C>(end) };
+            details::generate_array<N>(generator, m_engine, container);
 
             return container;
         }
 
+        /**
+        * \brief Fill [first, last) range with random values in a [from; to] range
+        * \param first, last - the range of elements to fill
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note The distribution is built once for the whole range
+        *       and nothing is allocated
+        */
+        template<typename ForwardIt, typename T>
+        typename std::enable_if<
+               details::is_iterator<ForwardIt>::value
+            && details::is_range_type<T>::value
+            >::type fill( ForwardIt first, ForwardIt last, T from, T to ) {
+            details::range_generator<T, IntegerDist, RealDist> generator{ from, to };
+            details::generate( generator, m_engine, first, last );
+        }
+
+        /**
+        * \brief Fill 'size' elements from 'data' pointer
+        *        with random values in a [from; to] range
+        * \param data Pointer to the first element to fill
+        * \param size The number of elements to fill
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        */
+        template<typename T>
+        typename std::enable_if<details::is_range_type<T>::value
+            >::type fill( T* data, std::size_t size, T from, T to ) {
+            details::range_generator<T, IntegerDist, RealDist> generator{ from, to };
+            details::generate_n( generator, m_engine, data, size );
+        }
+
+        /**
+        * \brief Fill all elements of container or span
+        *        with random values in a [from; to] range
+        * \param container The container with elements to fill
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        */
+        template<typename Container, typename T>
+        auto fill( Container&& container, T from, T to ) ->
+            typename std::enable_if<details::is_iterator<
+                decltype(std::begin(container))>::value
+                && details::is_range_type<T>::value
+            >::type {
+            fill( std::begin( container ), std::end( container ), from, to );
+        }
+
+        /**
+        * \brief Fill [first, last) range with random values in a [from; to] range
+        *        on several threads
+        * \param first, last - the random-access range of elements to fill
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param threads The number of threads, 0 means std::thread::hardware_concurrency
+        * \note The range is split into chunks of fixed size and every chunk gets
+        *       its own engine, seeded by std::seed_seq from a key drawn from the
+        *       internal engine and the chunk index. The result depends only on the
+        *       internal engine state and never on the number of threads
+        * \note The internal engine is advanced by 4 calls regardless of the range size
+        */
+        template<typename RandomIt, typename T>
+        typename std::enable_if<
+               std::is_base_of<std::random_access_iterator_tag,
+                   typename std::iterator_traits<RandomIt>::iterator_category>::value
+            && details::is_range_type<T>::value
+            >::type parallel_fill( RandomIt first, RandomIt last, T from, T to,
+                                   std::size_t threads = 0 ) {
+            details::range_generator<T, IntegerDist, RealDist> generator{ from, to };
+            details::parallel_generate( generator, m_engine, first, last, threads );
+        }
+
+        /**
+        * \brief Return lazy infinite range of random values in a [from; to] range
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \return Input range, std::ranges::view when ranges are available
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Values are generated in blocks, the view keeps a reference
+        *       to the internal engine and must not outlive it
+        */
+        template<typename T>
+        typename std::enable_if<details::is_range_type<T>::value
+            , details::random_view<details::range_generator<T, IntegerDist, RealDist>, Engine>
+            >::type view( T from, T to ) {
+            return { details::range_generator<T, IntegerDist, RealDist>{ from, to }, m_engine };
+        }
+
+        /**
+        * \brief Return lazy range of 'count' random values in a [from; to] range
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \param count The number of values in the range
+        * \return Input range, std::ranges::view when ranges are available
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Values are generated in blocks, the view keeps a reference
+        *       to the internal engine and must not outlive it
+        */
+        template<typename T>
+        typename std::enable_if<details::is_range_type<T>::value
+            , details::random_view<details::range_generator<T, IntegerDist, RealDist>, Engine>
+            >::type view( T from, T to, std::size_t count ) {
+            return { details::range_generator<T, IntegerDist, RealDist>{ from, to }, m_engine, count };
+        }
+
+        /**
+        * \brief Fill [first, last) range with normally distributed random values
+        * \param first, last - the range of elements to fill
+        * \param mean The mean of the distribution
+        * \param stddev The standard deviation of the distribution, should be positive
+        * \note Values are generated in blocks by Box-Muller transform,
+        *       both values of every pair are used
+        */
+        template<typename ForwardIt, typename T>
+        typename std::enable_if<
+               details::is_iterator<ForwardIt>::value
+            && std::is_floating_point<T>::value
+            >::type fill_normal( ForwardIt first, ForwardIt last, T mean, T stddev ) {
+            details::normal_generator<T, IntegerDist, RealDist> generator{ mean, stddev };
+            details::generate( generator, m_engine, first, last );
+        }
+
+        /**
+        * \brief Fill all elements of container or span
+        *        with normally distributed random values
+        * \param container The container with elements to fill
+        * \param mean The mean of the distribution
+        * \param stddev The standard deviation of the distribution, should be positive
+        */
+        template<typename Container, typename T>
+        auto fill_normal( Container&& container, T mean, T stddev ) ->
+            typename std::enable_if<details::is_iterator<
+                decltype(std::begin(container))>::value
+                && std::is_floating_point<T>::value
+            >::type {
+            fill_normal( std::begin( container ), std::end( container ), mean, stddev );
+        }
+
+        /**
+        * \brief Fill bits of 'words' by independent random bits
+        *        which are set with probability 'p'
+        * \param words The array of at least (nbits + 63) / 64 words
+        * \param nbits The number of bits to fill, bit i is bit (i % 64) of words[ i / 64 ]
+        * \param p The probability of a set bit in a [0; 1] range
+        * \note Bits past 'nbits' in the last word are cleared
+        * \note Sparse (p < 1/8) and dense (p > 7/8) bits are placed by geometric
+        *       skipping, at a cost proportional to the number of set or clear bits.
+        *       Other probabilities are rounded to 32 binary digits and
+        *       produced a word at a time
+        */
+        void fill_bernoulli_bits( std::uint64_t* words, std::size_t nbits, double p ) {
+            assert( 0. <= p && 1. >= p ); // out of [0; 1] range
+            details::bernoulli_bits( m_engine, words, nbits, p );
+        }
+
+        /**
+        * \brief Return bitset of 'size' independent random bits
+        *        which are set with probability 'p'
+        * \param size The number of bits
+        * \param p The probability of a set bit in a [0; 1] range
+        * \return Vector of (size + 63) / 64 words, bit i is bit (i % 64) of word i / 64
+        */
+        std::vector<std::uint64_t> random_bitset( std::size_t size, double p ) {
+            std::vector<std::uint64_t> words( ( size + 63 ) / 64 );
+            fill_bernoulli_bits( words.data( ), size, p );
+            return words;
+        }
+
+        /**
+        * \brief Write 'size' stratified random values in a [0; 1) range to 'out'
+        * \param size The number of values and strata
+        * \param out The beginning of the destination range of floating point values
+        * \return Iterator past the last written value
+        * \note Value i is uniform in [i / size; (i + 1) / size),
+        *       values are written in ascending order of strata
+        */
+        template<typename ForwardIt>
+        typename std::enable_if<
+            std::is_floating_point<typename std::iterator_traits<ForwardIt>::value_type>::value
+            , ForwardIt>::type stratified_uniform( std::size_t size, ForwardIt out ) {
+            details::range_generator<typename std::iterator_traits<ForwardIt>::value_type,
+                                     IntegerDist, RealDist> uniform{ 0, 1 };
+            return details::stratified_fill( uniform, m_engine, out, size );
+        }
+
+        /**
+        * \brief Write Latin hypercube design of 'size' random points
+        *        in a [0; 1)^dims cube to 'out'
+        * \param size The number of points
+        * \param dims The number of dimensions
+        * \param out The beginning of the destination range of size * dims
+        *        floating point values
+        * \return Iterator past the last written value
+        * \note The layout is structure of arrays: coordinate d of point i
+        *       is at out[ d * size + i ]
+        * \note Each of the 'size' equal strata of every dimension
+        *       holds exactly one point
+        */
+        template<typename RandomIt>
+        typename std::enable_if<
+            std::is_floating_point<typename std::iterator_traits<RandomIt>::value_type>::value
+            , RandomIt>::type latin_hypercube( std::size_t size, std::size_t dims, RandomIt out ) {
+            details::range_generator<typename std::iterator_traits<RandomIt>::value_type,
+                                     IntegerDist, RealDist> uniform{ 0, 1 };
+            return details::latin_hypercube( uniform, m_engine, size, dims, out );
+        }
+
+        /**
+        * \brief Write 'size' random bytes to memory at 'data'
+        * \param data Pointer to the first byte to write
+        * \param size The number of bytes to write
+        * \note Raw engine words are copied straight to the memory if
+        *       the engine produces full 32 or 64-bit words,
+        *       otherwise every byte is drawn by IntegerDist
+        */
+        void get_bytes( void* data, std::size_t size ) {
+            details::random_bytes<IntegerDist<unsigned short>>( m_engine,
+                static_cast<unsigned char*>( data ), size );
+        }
+
+        /**
+        * \brief Fill [first, last) range of bytes with random bytes
+        * \param first, last - the range of char, signed char,
+        *        unsigned char or std::byte elements
+        * \note Contiguous ranges of pointers are filled like by 'get_bytes'
+        */
+        template<typename ForwardIt>
+        typename std::enable_if<
+               details::is_iterator<ForwardIt>::value
+            && details::is_byte_storage<
+                   typename std::iterator_traits<ForwardIt>::value_type>::value
+            >::type fill_bytes( ForwardIt first, ForwardIt last ) {
+            details::random_bytes<IntegerDist<unsigned short>>( m_engine, first, last );
+        }
+
+        /**
+        * \brief Write 'size' random values in a [from; to] range to 'out'
+        * \param out The output iterator, like std::back_inserter
+        *        or std::ostream_iterator
+        * \param size The number of values to write
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \return Output iterator past the last written value
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Values are generated in blocks by the bulk kernels
+        */
+        template<typename OutputIt, typename T>
+        typename std::enable_if<details::is_range_type<T>::value
+            , OutputIt>::type generate_n( OutputIt out, std::size_t size, T from, T to ) {
+            details::range_generator<T, IntegerDist, RealDist> generator{ from, to };
+            return details::generate_n( generator, m_engine, out, size );
+        }
+
+        /**
+        * \brief Write 'size' random common_type values in a [from; to] range to 'out'
+        * \param Key The Key type for this version of 'generate_n' method
+        *        Type should be '(THIS_TYPE)::common' struct
+        * \param out The output iterator
+        * \param size The number of values to write
+        * \param from The first limit number of a random range
+        * \param to The second limit number of a random range
+        * \return Output iterator past the last written value
+        * \note Allow both: 'from' <= 'to' and 'from' >= 'to'
+        * \note Prevent implicit type conversion from signed to unsigned types
+        */
+        template<
+            typename Key,
+            typename OutputIt,
+            typename A,
+            typename B,
+            typename C = typename std::common_type<A, B>::type
+        >
+        typename std::enable_if<
+               std::is_same<Key, common>::value
+            && details::is_supported_number<A>::value
+            && details::is_supported_number<B>::value
+            // Prevent implicit type conversion from signed to unsigned types
+            && std::is_signed<A>::value != std::is_unsigned<B>::value
+            , OutputIt>::type generate_n( OutputIt out, std::size_t size, A from, B to ) {
+            return generate_n( out, size, static_cast<C>( from ), static_cast<C>( to ) );
+        }
+
         /**
         * \brief Return random pointer from built-in array
         * \param array The built-in array with elements
@@ -1426,15 +4487,82 @@ namespace effolkronium {
             return std::end(map_container);
         }
 
+        /**
+        * \brief Return a random iterator from given contiguous container
+        *        by utilizing its real values as weights
+        *        for weighted random number generation
+        * \param Key The Key type for this version of 'get' method
+        *        Type should be '(THIS_TYPE)::weight' struct
+        * \param weights A contiguous container of non-negative real weights,
+        *        like std::vector<double> or std::array<float, N>
+        * \note return the end iterator if the container is empty or total weight is zero
+        * \note The weights are summed and searched block by block,
+        *       the sum vectorizes, the search skips a block per lane sum
+        */
+        template<
+            typename Key,
+            class Container
+        >
+        auto get(const Container& weights) -> typename std::enable_if<
+            !details::is_map<Container>::value &&
+            details::is_contiguous<Container>::value &&
+            details::is_uniform_real<typename Container::value_type>::value &&
+            std::is_same<Key, details::weight>::value,
+        decltype(std::begin(weights))>::type {
+            using ValueType = typename Container::value_type;
+            using DiffType = typename std::iterator_traits<decltype(std::begin(weights))>::difference_type;
+
+            const ValueType* data = weights.data( );
+            const std::size_t size = weights.size( );
+            assert(std::all_of(data, data + size,
+                [](ValueType value) { return value >= ValueType(0); }));
+
+            const ValueType total_weight = details::weight_sum(data, size);
+            if(!(total_weight > ValueType(0))) return std::end(weights);
+
+            ValueType random_weight = get(ValueType(0), std::nextafter(total_weight, (std::numeric_limits<ValueType>::min)( )));
+            return std::next(std::begin(weights),
+                static_cast<DiffType>(details::weight_search(data, size, random_weight)));
+        }
+
+        /**
+        * \brief Write 'count' random iterators from given weighted container
+        *        to 'out', built from a single pass over the weights
+        * \param Key The Key type for this version of 'get' method
+        *        Type should be '(THIS_TYPE)::weight' struct
+        * \param container A map-like container with unsigned integer or real
+        *        mapped values, or a contiguous container of real weights
+        * \param count The number of weighted random selections
+        * \param out The output iterator receiving container iterators
+        * \return Output iterator past the last written element
+        * \note Costs O(count + size) instead of O(count * size) of repeated calls
+        * \note Selections are written in container order, nothing is written
+        *       if the container is empty or total weight is zero
+        */
+        template<
+            typename Key,
+            class Container,
+            class OutputIt
+        >
+        auto get(const Container& container, std::size_t count, OutputIt out) -> typename std::enable_if<
+            details::is_weight<typename details::weight_type<Container>::type>::value &&
+            std::is_same<Key, details::weight>::value,
+        OutputIt>::type {
+            return details::weighted_draws(m_engine, container, count, out);
+        }
+
         /**
         * \brief Reorders the elements in the given range [first, last)
         *        such that each possible permutation of those elements
         *        has equal probability of appearance.
         * \param first, last - the range of elements to shuffle randomly       
+        * \note Fisher-Yates shuffle which takes several indices from every
+        *       64-bit engine word, engines without full 32 or 64-bit output
+        *       are passed to std::shuffle
         */
         template<typename RandomIt>
         void shuffle( RandomIt first, RandomIt last ) {
-            std::shuffle( first, last, m_engine );
+            details::shuffle( first, last, m_engine );
         }
 
         /**
@@ -1448,6 +4576,180 @@ namespace effolkronium {
             shuffle( std::begin( container ), std::end( container ) );
         }
 
+        /**
+        * \brief Reorders the elements in the given range [first, last)
+        *        such that each possible permutation of those elements
+        *        has equal probability of appearance, with cache-aware buckets
+        * \param Key The Key type for this version of 'shuffle' method
+        *     Type should be '(THIS_TYPE)::bucketed' struct
+        * \param first, last - the random-access range of elements to shuffle randomly
+        * \note Elements are scattered to cache-sized random buckets, which
+        *       are shuffled one by one. Ranges much larger than the last-level
+        *       cache are shuffled with far fewer cache misses, at the cost of
+        *       a temporary copy of the range
+        */
+        template<typename Key, typename RandomIt>
+        typename std::enable_if<
+            std::is_same<Key, bucketed>::value
+            >::type shuffle( RandomIt first, RandomIt last ) {
+            details::bucketed_shuffle( first, last, m_engine );
+        }
+
+        /**
+        * \brief Reorders the elements in the given container
+        *        such that each possible permutation of those elements
+        *        has equal probability of appearance, with cache-aware buckets
+        * \param Key The Key type for this version of 'shuffle' method
+        *     Type should be '(THIS_TYPE)::bucketed' struct
+        * \param container - the container with elements to shuffle randomly
+        */
+        template<typename Key, typename Container>
+        typename std::enable_if<
+            std::is_same<Key, bucketed>::value
+            >::type shuffle( Container& container ) {
+            shuffle<Key>( std::begin( container ), std::end( container ) );
+        }
+
+        /**
+        * \brief Moves k random elements of the range [first, last)
+        *        to its beginning, in random order. Each possible
+        *        k-permutation has equal probability of appearance.
+        * \param first, last - the random-access range of elements
+        * \param k The number of elements to select, at most the range size
+        * \return Iterator past the k-th element
+        * \note Only k Fisher-Yates steps are done, so it costs O(k)
+        */
+        template<typename RandomIt>
+        typename std::enable_if<
+            std::is_base_of<std::random_access_iterator_tag,
+                typename std::iterator_traits<RandomIt>::iterator_category>::value
+            , RandomIt>::type partial_shuffle( RandomIt first, RandomIt last, std::size_t k ) {
+            return details::partial_shuffle( first, last, k, m_engine );
+        }
+
+        /**
+        * \brief Moves k random elements of the container
+        *        to its beginning, in random order
+        * \param container - the container with elements to select
+        * \param k The number of elements to select, at most the container size
+        * \return Iterator past the k-th element
+        */
+        template<typename Container>
+        auto partial_shuffle( Container& container, std::size_t k )
+            -> decltype( std::begin( container ) ) {
+            return partial_shuffle( std::begin( container ), std::end( container ), k );
+        }
+
+        /**
+        * \brief Copies k random elements of the range [first, last)
+        *        to 'out', in random order. Each possible
+        *        k-permutation has equal probability of appearance.
+        * \param first, last - the random-access range of elements
+        * \param k The number of elements to copy, at most the range size
+        * \param out The output iterator
+        * \return Output iterator past the last copied element
+        * \note The range is not modified, time and memory are O(k)
+        */
+        template<typename RandomIt, typename OutputIt>
+        typename std::enable_if<
+            std::is_base_of<std::random_access_iterator_tag,
+                typename std::iterator_traits<RandomIt>::iterator_category>::value
+            , OutputIt>::type sample( RandomIt first, RandomIt last, std::size_t k, OutputIt out ) {
+            return details::sample( first, last, k, out, m_engine );
+        }
+
+        /**
+        * \brief Copies k random elements of the range [first, last)
+        *        to random-access 'out' in a single pass, in random order.
+        *        Each possible k-permutation has equal probability of appearance.
+        * \param first, last - the input or forward range of elements
+        * \param k The number of elements to copy
+        * \param out The random-access output iterator to at least k elements
+        * \return Output iterator past the last copied element,
+        *         less than k elements are copied from short ranges
+        * \note Reservoir sampling by Algorithm L: the range is traversed once
+        *       and only O(k log(n / k)) random numbers are drawn
+        */
+        template<typename InputIt, typename RandomOut>
+        typename std::enable_if<
+               details::is_iterator<InputIt>::value
+            && !std::is_base_of<std::random_access_iterator_tag,
+                   typename std::iterator_traits<InputIt>::iterator_category>::value
+            && std::is_base_of<std::random_access_iterator_tag,
+                   typename std::iterator_traits<RandomOut>::iterator_category>::value
+            , RandomOut>::type sample( InputIt first, InputIt last, std::size_t k, RandomOut out ) {
+            return details::reservoir_sample<IntegerDist<std::size_t>>( first, last, k, out, m_engine );
+        }
+
+        /**
+        * \brief Return vector of k random elements of the range [first, last),
+        *        in random order
+        * \param first, last - the range of elements, input iterators are
+        *        traversed once by reservoir sampling
+        * \param k The number of elements to select
+        * \return Vector of selected elements,
+        *         less than k elements for short ranges
+        */
+        template<typename InputIt>
+        typename std::enable_if<details::is_iterator<InputIt>::value
+            , std::vector<typename std::iterator_traits<InputIt>::value_type>
+            >::type sample( InputIt first, InputIt last, std::size_t k ) {
+            return details::sample_vector<IntegerDist<std::size_t>>( first, last, k, m_engine,
+                typename std::iterator_traits<InputIt>::iterator_category{ } );
+        }
+
+        /**
+        * \brief Return pseudorandom permutation of [0; size)
+        *        keyed by a seed from the internal engine
+        * \param size The number of permuted values
+        * \return Permutation with random access and iteration in O(1) memory
+        */
+        random_permutation permutation( std::uint64_t size ) {
+            return random_permutation{ size, details::next_wide_word( m_engine ) };
+        }
+
+        /**
+        * \brief Return pseudorandom permutation of [0; size) keyed by 'seed'
+        * \param size The number of permuted values
+        * \param seed The key of the permutation
+        * \return Permutation with random access and iteration in O(1) memory
+        * \note The internal engine is not used
+        */
+        random_permutation permutation( std::uint64_t size, std::uint64_t seed ) {
+            return random_permutation{ size, seed };
+        }
+
+        /**
+        * \brief Reorders the elements in the given range [first, last)
+        *        on several threads such that each possible permutation
+        *        of those elements has equal probability of appearance.
+        * \param first, last - the random-access range of elements to shuffle randomly
+        * \param threads The number of threads, 0 means std::thread::hardware_concurrency
+        * \note Blocks of the range are shuffled independently and merged
+        *       pairwise (MergeShuffle). The result depends only on the internal
+        *       engine state and never on the number of threads
+        * \note The internal engine is advanced by 4 calls regardless of the range size
+        */
+        template<typename RandomIt>
+        typename std::enable_if<
+            std::is_base_of<std::random_access_iterator_tag,
+                typename std::iterator_traits<RandomIt>::iterator_category>::value
+            >::type parallel_shuffle( RandomIt first, RandomIt last, std::size_t threads = 0 ) {
+            details::parallel_shuffle( first, last, m_engine, threads );
+        }
+
+        /**
+        * \brief Reorders the elements in the given container
+        *        on several threads such that each possible permutation
+        *        of those elements has equal probability of appearance.
+        * \param container - the container with elements to shuffle randomly
+        * \param threads The number of threads, 0 means std::thread::hardware_concurrency
+        */
+        template<typename Container>
+        void parallel_shuffle( Container& container, std::size_t threads = 0 ) {
+            parallel_shuffle( std::begin( container ), std::end( container ), threads );
+        }
+
         /// return internal engine by copy
         Engine get_engine( ) const {
             return m_engine;
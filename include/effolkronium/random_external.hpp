@@ -0,0 +1,379 @@
+/*
+______  ___   _   _______ ________  __
+| ___ \/ _ \ | \ | |  _  \  _  |  \/  | Random for modern C++
+| |_/ / /_\ \|  \| | | | | | | | .  . |
+|    /|  _  || . ` | | | | | | | |\/| | version 1.5.0
+| |\ \| | | || |\  | |/ /\ \_/ / |  | |
+\_| \_\_| |_/\_| \_/___/  \___/\_|  |_/ https://github.com/effolkronium/random
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+Copyright (c) 2017-2024 effolkronium (Illia Polishchuk)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files( the "Software" ), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef EFFOLKRONIUM_RANDOM_EXTERNAL_HPP
+#define EFFOLKRONIUM_RANDOM_EXTERNAL_HPP
+
+#include "random.hpp"
+
+#include <cerrno>
+#include <cmath> // std::log
+#include <cstdint>
+#include <cstdio> // std::tmpfile
+#include <cstring> // std::memcpy
+#include <functional> // std::greater
+#include <istream>
+#include <ostream>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace effolkronium {
+
+    namespace details {
+        /// Anonymous temporary file, removed when closed
+        class spill_file {
+        public:
+            spill_file( ) : m_file( std::tmpfile( ) ) {
+                if( nullptr == m_file )
+                    throw std::system_error( errno, std::generic_category( ), "cannot create spill file" );
+            }
+
+            spill_file( spill_file&& other ) noexcept : m_file( other.m_file ) {
+                other.m_file = nullptr;
+            }
+
+            spill_file( const spill_file& ) = delete;
+            spill_file& operator=( const spill_file& ) = delete;
+            spill_file& operator=( spill_file&& ) = delete;
+
+            ~spill_file( ) {
+                close( );
+            }
+
+            /// Close and remove the file
+            void close( ) {
+                if( nullptr != m_file )
+                    std::fclose( m_file );
+                m_file = nullptr;
+            }
+
+            /// Append 'size' bytes
+            void write( const unsigned char* data, std::size_t size ) {
+                if( size != std::fwrite( data, 1, size, m_file ) )
+                    throw std::system_error( errno, std::generic_category( ), "cannot write spill file" );
+            }
+
+            /// Read 'size' bytes, return false at the end of the file
+            bool read( unsigned char* data, std::size_t size ) {
+                const std::size_t done = std::fread( data, 1, size, m_file );
+                if( done == size ) return true;
+                if( std::ferror( m_file ) )
+                    throw std::system_error( errno, std::generic_category( ), "cannot read spill file" );
+                return false;
+            }
+
+            /// Start reading from the beginning
+            void rewind( ) {
+                std::rewind( m_file );
+            }
+        private:
+            std::FILE* m_file;
+        };
+
+        /// Input iterator over fixed-size records of a binary stream
+        class record_iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::string;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string*;
+            using reference = const std::string&;
+
+            /// Construct end iterator
+            record_iterator( ) = default;
+
+            record_iterator( std::istream& in, std::size_t record_size )
+                : m_in( &in ), m_record( record_size, '\0' ) {
+                next( );
+            }
+
+            reference operator*( ) const { return m_record; }
+
+            pointer operator->( ) const { return &m_record; }
+
+            record_iterator& operator++( ) {
+                next( );
+                return *this;
+            }
+
+            record_iterator operator++( int ) {
+                record_iterator previous = *this;
+                next( );
+                return previous;
+            }
+
+            friend bool operator==( const record_iterator& lhs, const record_iterator& rhs ) {
+                return lhs.m_in == rhs.m_in;
+            }
+
+            friend bool operator!=( const record_iterator& lhs, const record_iterator& rhs ) {
+                return lhs.m_in != rhs.m_in;
+            }
+        private:
+            void next( ) {
+                m_in->read( &m_record[ 0 ], static_cast<std::streamsize>( m_record.size( ) ) );
+                const auto done = static_cast<std::size_t>( m_in->gcount( ) );
+                if( 0 == done )
+                    m_in = nullptr;
+                else if( m_record.size( ) != done )
+                    throw std::runtime_error( "truncated record at the end of input" );
+            }
+        private:
+            std::istream* m_in = nullptr;
+            std::string m_record;
+        };
+
+        /// Return reader of 'record_size' byte records from 'in'
+        inline std::function<bool( unsigned char* )> stream_records( std::istream& in, std::size_t record_size ) {
+            return [ &in, record_size ]( unsigned char* record ) {
+                in.read( reinterpret_cast<char*>( record ), static_cast<std::streamsize>( record_size ) );
+                const auto done = static_cast<std::size_t>( in.gcount( ) );
+                if( 0 != done && record_size != done )
+                    throw std::runtime_error( "truncated record at the end of input" );
+                return record_size == done;
+            };
+        }
+
+        /// Write 'size' bytes to 'out'
+        inline void write_bytes( std::ostream& out, const unsigned char* data, std::size_t size ) {
+            if( !out.write( reinterpret_cast<const char*>( data ), static_cast<std::streamsize>( size ) ) )
+                throw std::runtime_error( "cannot write output" );
+        }
+
+        /**
+        * \brief Uniform random integer in a [from; to] range drawn by the
+        *        library's batched kernel, so the result depends only on the
+        *        engine output, not on the standard library implementation
+        */
+        class engine_index {
+        public:
+            using result_type = std::size_t;
+
+            engine_index( std::size_t from, std::size_t to )
+                : m_from( from ), m_bound( std::uint64_t( to - from ) + 1 ) { }
+
+            template<typename Engine>
+            result_type operator()( Engine& engine ) const {
+                std::uint64_t index;
+                batched_indices( engine, m_bound, 1, &index );
+                return m_from + static_cast<std::size_t>( index );
+            }
+        private:
+            std::size_t m_from;
+            std::uint64_t m_bound;
+        };
+
+        /**
+        * \brief Write records from 'read' to 'out' in uniformly random order
+        * \note Input which fits 'memory' is shuffled in memory. Larger input is
+        *       scattered to 'buckets' spill files by uniform random labels and
+        *       every bucket is shuffled the same way, recursively
+        */
+        template<typename Engine>
+        void external_shuffle( const std::function<bool( unsigned char* )>& read, std::ostream& out,
+                               std::size_t record_size, Engine& engine,
+                               std::size_t memory, std::size_t buckets ) {
+            const std::size_t capacity = memory / record_size > 2 ? memory / record_size : 2;
+            std::vector<unsigned char> records;
+            // Reserved once, so growing never holds two buffers
+            records.reserve( ( capacity + 1 ) * record_size );
+            records.resize( record_size );
+            std::size_t count = 0;
+            while( count < capacity && read( records.data( ) + count * record_size ) ) {
+                ++count;
+                records.resize( ( count + 1 ) * record_size );
+            }
+
+            std::vector<unsigned char> record( record_size );
+            if( count < capacity || !read( record.data( ) ) ) {
+                unsigned char* data = records.data( );
+                fisher_yates_indices( engine, count, count, [ data, record_size ]( std::uint64_t i, std::uint64_t j ) {
+                    std::swap_ranges( data + i * record_size, data + ( i + 1 ) * record_size,
+                                      data + j * record_size );
+                } );
+                write_bytes( out, data, count * record_size );
+                return;
+            }
+
+            std::vector<spill_file> spills( buckets );
+            engine_index label{ 0, buckets - 1 };
+            for( std::size_t i = 0; i < count; ++i )
+                spills[ label( engine ) ].write( records.data( ) + i * record_size, record_size );
+            std::vector<unsigned char>( ).swap( records );
+            do {
+                spills[ label( engine ) ].write( record.data( ), record_size );
+            } while( read( record.data( ) ) );
+
+            for( auto& spill : spills ) {
+                spill.rewind( );
+                external_shuffle( [ &spill, record_size ]( unsigned char* data ) {
+                    return spill.read( data, record_size );
+                }, out, record_size, engine, memory, buckets );
+                spill.close( ); // free the disk space before the next bucket
+            }
+        }
+    } // namespace details
+
+    /// Default memory budget of out-of-core algorithms, in bytes
+    constexpr std::size_t external_memory = std::size_t{ 64 } << 20;
+
+    /// Default number of spill buckets of external_shuffle
+    constexpr std::size_t external_buckets = 64;
+
+    /**
+    * \brief Write fixed-size records of 'in' to 'out' in uniformly random order,
+    *        using bounded memory
+    * \param in, out - binary streams of records
+    * \param record_size The size of every record in bytes
+    * \param engine The random engine, e.g. 'engine( )' of random_local,
+    *        the same engine state gives the same output with any standard
+    *        library if the engine produces full 32 or 64-bit words
+    * \param memory The memory budget in bytes
+    * \param buckets The number of temporary spill files per level, at least 2
+    * \note Input larger than 'memory' is scattered to random buckets in
+    *       anonymous temporary files, which are shuffled one by one,
+    *       so every record is written to disk about once per level
+    * \throw std::invalid_argument if 'record_size' is zero or 'buckets' is less than 2
+    * \throw std::runtime_error if the input ends with a partial record
+    *        or the output can't be written
+    * \throw std::system_error if a spill file can't be created or written
+    */
+    template<typename Engine>
+    void external_shuffle( std::istream& in, std::ostream& out, std::size_t record_size, Engine& engine,
+                           std::size_t memory = external_memory, std::size_t buckets = external_buckets ) {
+        if( 0 == record_size )
+            throw std::invalid_argument( "record size should be positive" );
+        if( buckets < 2 )
+            throw std::invalid_argument( "at least 2 buckets are needed" );
+        details::external_shuffle( details::stream_records( in, record_size ),
+                                   out, record_size, engine, memory, buckets );
+    }
+
+    /**
+    * \brief Write fixed-size records of memory region, e.g. of a mapped file,
+    *        to 'out' in uniformly random order, using bounded memory
+    * \param data, size - the region of records, 'size' in bytes
+    * \note Same as the stream version, the region is read sequentially once
+    * \throw std::invalid_argument if 'size' isn't a multiple of 'record_size'
+    *        or 'buckets' is less than 2
+    */
+    template<typename Engine>
+    void external_shuffle( const void* data, std::size_t size, std::ostream& out,
+                           std::size_t record_size, Engine& engine,
+                           std::size_t memory = external_memory, std::size_t buckets = external_buckets ) {
+        if( 0 == record_size || 0 != size % record_size )
+            throw std::invalid_argument( "region should consist of whole records" );
+        if( buckets < 2 )
+            throw std::invalid_argument( "at least 2 buckets are needed" );
+        const unsigned char* next = static_cast<const unsigned char*>( data );
+        const unsigned char* const end = next + size;
+        details::external_shuffle( [ &next, end, record_size ]( unsigned char* record ) {
+            if( next == end ) return false;
+            std::memcpy( record, next, record_size );
+            next += record_size;
+            return true;
+        }, out, record_size, engine, memory, buckets );
+    }
+
+    /**
+    * \brief Return k uniformly random fixed-size records of 'in',
+    *        in random order, in a single pass
+    * \param in The binary stream of records
+    * \param record_size The size of every record in bytes
+    * \param k The number of records to select
+    * \param engine The random engine, the same engine state gives the same records
+    * \return Selected records, fewer than k for short input
+    * \note Reservoir sampling by Algorithm L, only k records are held in memory
+    * \throw std::invalid_argument if 'record_size' is zero
+    * \throw std::runtime_error if the input ends with a partial record
+    */
+    template<typename Engine>
+    std::vector<std::string> sample_records( std::istream& in, std::size_t record_size,
+                                             std::size_t k, Engine& engine ) {
+        if( 0 == record_size )
+            throw std::invalid_argument( "record size should be positive" );
+        return details::sample_vector<details::engine_index>(
+            details::record_iterator{ in, record_size },
+            details::record_iterator{ }, k, engine, std::input_iterator_tag{ } );
+    }
+
+    /**
+    * \brief Return k fixed-size records of 'in' sampled without replacement
+    *        with probabilities proportional to their weights, in a single pass
+    * \param in The binary stream of records
+    * \param record_size The size of every record in bytes
+    * \param k The number of records to select
+    * \param engine The random engine, the same engine state gives the same records
+    * \param weight Function returning the weight of a record passed as
+    *        const std::string&, records with non-positive weight are skipped
+    * \return Selected records in the order of weighted sampling without
+    *         replacement, fewer than k if there are not enough positive weights
+    * \note A-Res algorithm (Efraimidis and Spirakis): every record gets the key
+    *       log(u) / weight and the k largest keys are kept in a heap,
+    *       so only k records are held in memory
+    * \throw std::invalid_argument if 'record_size' is zero
+    * \throw std::runtime_error if the input ends with a partial record
+    */
+    template<typename Engine, typename Weight>
+    std::vector<std::string> weighted_sample_records( std::istream& in, std::size_t record_size,
+                                                      std::size_t k, Engine& engine, Weight weight ) {
+        if( 0 == record_size )
+            throw std::invalid_argument( "record size should be positive" );
+        using entry = std::pair<double, std::string>;
+        std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap; // smallest key on top
+        if( 0 == k )
+            return { };
+
+        for( details::record_iterator it{ in, record_size }, end; it != end; ++it ) {
+            const auto record_weight = static_cast<double>( weight( *it ) );
+            if( !( record_weight > 0. ) )
+                continue;
+            const double key = std::log( details::open_canonical( engine ) ) / record_weight;
+            if( heap.size( ) < k ) {
+                heap.emplace( key, *it );
+            } else if( key > heap.top( ).first ) {
+                heap.pop( );
+                heap.emplace( key, *it );
+            }
+        }
+
+        std::vector<std::string> selected( heap.size( ) );
+        for( auto it = selected.rbegin( ); it != selected.rend( ); ++it, heap.pop( ) )
+            *it = heap.top( ).second;
+        return selected;
+    }
+
+} // namespace effolkronium
+
+#endif // #ifndef EFFOLKRONIUM_RANDOM_EXTERNAL_HPP
@@ -0,0 +1,371 @@
+/*
+______  ___   _   _______ ________  __
+| ___ \/ _ \ | \ | |  _  \  _  |  \/  | Random for modern C++
+| |_/ / /_\ \|  \| | | | | | | | .  . |
+|    /|  _  || . ` | | | | | | | |\/| | version 1.5.0
+| |\ \| | | || |\  | |/ /\ \_/ / |  | |
+\_| \_\_| |_/\_| \_/___/  \___/\_|  |_/ https://github.com/effolkronium/random
+
+Licensed under the MIT License <http://opensource.org/licenses/MIT>.
+Copyright (c) 2017-2024 effolkronium (Illia Polishchuk)
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files( the "Software" ), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef EFFOLKRONIUM_RANDOM_MMAP_HPP
+#define EFFOLKRONIUM_RANDOM_MMAP_HPP
+
+#include "random.hpp"
+
+#include <cstdint>
+#include <cstdio> // std::rename, std::remove
+#include <cstring> // std::memcpy
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace effolkronium {
+
+    namespace details {
+        /// Read-only memory mapping of a whole file, shared between processes
+        class mapped_file {
+        public:
+            explicit mapped_file( const std::string& path ) {
+#ifdef _WIN32
+                HANDLE file = ::CreateFileA( path.c_str( ), GENERIC_READ, FILE_SHARE_READ,
+                    nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr );
+                if( INVALID_HANDLE_VALUE == file )
+                    throw_last_error( "cannot open " + path );
+
+                LARGE_INTEGER file_size;
+                if( !::GetFileSizeEx( file, &file_size ) ) {
+                    ::CloseHandle( file );
+                    throw_last_error( "cannot stat " + path );
+                }
+                m_size = static_cast<std::size_t>( file_size.QuadPart );
+
+                HANDLE mapping = ::CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+                ::CloseHandle( file );
+                if( nullptr == mapping )
+                    throw_last_error( "cannot map " + path );
+
+                m_data = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+                ::CloseHandle( mapping ); // the view keeps the mapping alive
+                if( nullptr == m_data )
+                    throw_last_error( "cannot map " + path );
+#else
+                const int file = ::open( path.c_str( ), O_RDONLY );
+                if( -1 == file )
+                    throw std::system_error( errno, std::generic_category( ), "cannot open " + path );
+
+                struct stat status;
+                if( -1 == ::fstat( file, &status ) ) {
+                    const int error = errno;
+                    ::close( file );
+                    throw std::system_error( error, std::generic_category( ), "cannot stat " + path );
+                }
+                m_size = static_cast<std::size_t>( status.st_size );
+
+                void* data = ::mmap( nullptr, m_size, PROT_READ, MAP_SHARED, file, 0 );
+                const int error = errno;
+                ::close( file ); // the mapping keeps the file alive
+                if( MAP_FAILED == data )
+                    throw std::system_error( error, std::generic_category( ), "cannot map " + path );
+
+                m_data = data;
+                // Draws touch pages in random order, read-ahead only wastes memory
+                ::madvise( m_data, m_size, MADV_RANDOM );
+#endif
+            }
+
+            mapped_file( mapped_file&& other ) noexcept
+                : m_data( other.m_data ), m_size( other.m_size ) {
+                other.m_data = nullptr;
+                other.m_size = 0;
+            }
+
+            mapped_file& operator=( mapped_file&& other ) noexcept {
+                if( this != &other ) {
+                    unmap( );
+                    m_data = other.m_data;
+                    m_size = other.m_size;
+                    other.m_data = nullptr;
+                    other.m_size = 0;
+                }
+                return *this;
+            }
+
+            mapped_file( const mapped_file& ) = delete;
+            mapped_file& operator=( const mapped_file& ) = delete;
+
+            ~mapped_file( ) {
+                unmap( );
+            }
+
+            /// return pointer to the first byte of the file
+            const unsigned char* data( ) const {
+                return static_cast<const unsigned char*>( m_data );
+            }
+
+            /// return size of the file in bytes
+            std::size_t size( ) const {
+                return m_size;
+            }
+        private:
+            void unmap( ) {
+                if( nullptr == m_data ) return;
+#ifdef _WIN32
+                ::UnmapViewOfFile( m_data );
+#else
+                ::munmap( m_data, m_size );
+#endif
+                m_data = nullptr;
+            }
+
+#ifdef _WIN32
+            static void throw_last_error( const std::string& what ) {
+                throw std::system_error( static_cast<int>( ::GetLastError( ) ),
+                                         std::system_category( ), what );
+            }
+#endif
+        private:
+            void* m_data = nullptr;
+            std::size_t m_size = 0;
+        };
+
+        /// Leading bytes of a mapped_guide_table file
+        struct mapped_table_header {
+            char magic[ 8 ];
+            std::uint64_t size;
+            std::uint64_t last;
+            std::uint64_t guide_size;
+        };
+
+        constexpr char mapped_table_magic[ 8 ] = { 'E', 'F', 'R', 'N', 'D', 'G', 'T', '1' };
+    } // namespace details
+
+    /**
+    * \brief Guide table distribution stored in a read-only memory-mapped file
+    * \note The file is built once by 'build' and then mapped without
+    *       copying; every process mapping it shares the same pages
+    * \note Draws are identical to effolkronium::guide_table<double>
+    *       over the same weights
+    * \note The file layout uses the native byte order
+    */
+    class mapped_guide_table {
+    public:
+        /// Type of generated indices
+        using result_type = std::size_t;
+
+        /**
+        * \brief Write the table for weights in [first, last) range to 'path'
+        * \note Weights are read in a single pass and never held in memory
+        * \note Weights should be non-negative with positive sum
+        * \note The table is written to 'path' + ".tmp" and renamed over 'path'
+        *       only when complete, so a failed build leaves the previous
+        *       table intact and processes which map it are not affected
+        * \throw std::runtime_error if the file can't be written
+        * \throw std::invalid_argument if the total weight isn't positive
+        */
+        template<typename InputIt>
+        static void build( const std::string& path, InputIt first, InputIt last ) {
+            const std::string temp = path + ".tmp";
+            try {
+                write_table( temp, first, last );
+                replace( temp, path );
+            } catch( ... ) {
+                std::remove( temp.c_str( ) );
+                throw;
+            }
+        }
+
+        /**
+        * \brief Map the table file built by 'build' read-only
+        * \throw std::system_error if the file can't be mapped
+        * \throw std::runtime_error if the file isn't a table
+        */
+        explicit mapped_guide_table( const std::string& path )
+            : m_file( path ) {
+            details::mapped_table_header header;
+            if( m_file.size( ) < sizeof header )
+                throw std::runtime_error( "effolkronium::mapped_guide_table: " + path + " is not a table" );
+            std::memcpy( &header, m_file.data( ), sizeof header );
+
+            if( 0 != std::memcmp( header.magic, details::mapped_table_magic, sizeof header.magic )
+                || 0 == header.size || header.last >= header.size || 0 == header.guide_size
+                || m_file.size( ) != sizeof header
+                    + header.size * sizeof( double )
+                    + header.guide_size * sizeof( std::uint64_t ) )
+                throw std::runtime_error( "effolkronium::mapped_guide_table: " + path + " is not a table" );
+
+            m_size = static_cast<std::size_t>( header.size );
+            m_last = static_cast<std::size_t>( header.last );
+            m_guide_size = static_cast<std::size_t>( header.guide_size );
+            m_cumulative = cumulative_of( m_file );
+            m_guide = static_cast<const std::uint64_t*>( static_cast<const void*>(
+                m_file.data( ) + sizeof header + m_size * sizeof( double ) ) );
+        }
+
+        /// Return random index by internal uniform number from 'engine'
+        template<typename Engine>
+        result_type operator()( Engine& engine ) const {
+            return quantile( details::canonical<double>( engine ) );
+        }
+
+        /**
+        * \brief Return index for a given uniform number
+        * \param u A number in [0; 1) range
+        * \return The smallest index whose cumulative weight exceeds u * total
+        */
+        result_type quantile( double u ) const {
+            assert( 0 <= u && 1 > u ); // out of [0; 1) range
+            return details::guide_search( m_cumulative, m_last, m_guide, m_guide_size, u );
+        }
+
+        /// Number of weights
+        std::size_t size( ) const { return m_size; }
+
+        /// Sum of all weights
+        double total( ) const { return m_cumulative[ m_last ]; }
+
+        /// The smallest potentially generated index
+        result_type (min)( ) const { return 0; }
+
+        /// The largest potentially generated index
+        result_type (max)( ) const { return m_last; }
+
+        /// Draws are independent, nothing to reset
+        void reset( ) { }
+    private:
+        /// Number of values buffered before each write while building
+        static constexpr std::size_t buffer_size = 1 << 16;
+
+        template<typename InputIt>
+        static void write_table( const std::string& path, InputIt first, InputIt last ) {
+            details::mapped_table_header header = { };
+            std::memcpy( header.magic, details::mapped_table_magic, sizeof header.magic );
+            header.size = 0;
+            header.last = 0;
+
+            {
+                std::ofstream file( path, std::ios::binary | std::ios::trunc );
+                write( file, &header, 1, path );
+
+                std::vector<double> buffer;
+                buffer.reserve( buffer_size );
+                double sum = 0;
+                for( ; first != last; ++first ) {
+                    const double weight = static_cast<double>( *first );
+                    assert( weight >= 0 );
+                    if( weight > 0 ) header.last = header.size;
+                    sum += weight;
+                    buffer.push_back( sum );
+                    ++header.size;
+                    if( buffer.size( ) == buffer_size ) {
+                        write( file, buffer.data( ), buffer.size( ), path );
+                        buffer.clear( );
+                    }
+                }
+                write( file, buffer.data( ), buffer.size( ), path );
+                close( file, path );
+
+                if( !( sum > 0 ) )
+                    throw std::invalid_argument( "effolkronium::mapped_guide_table: total weight should be positive" );
+            }
+            header.guide_size = header.size;
+
+            {
+                // Guide entries come from the cumulative weights already on disk
+                const details::mapped_file cumulative_file( path );
+                const double* cumulative = cumulative_of( cumulative_file );
+
+                std::ofstream file( path, std::ios::binary | std::ios::app );
+                std::vector<std::uint64_t> buffer;
+                buffer.reserve( buffer_size );
+                details::guide_build( cumulative, static_cast<std::size_t>( header.last ),
+                    static_cast<std::size_t>( header.guide_size ),
+                    [ & ]( std::size_t index ) {
+                        buffer.push_back( index );
+                        if( buffer.size( ) == buffer_size ) {
+                            write( file, buffer.data( ), buffer.size( ), path );
+                            buffer.clear( );
+                        }
+                    } );
+                write( file, buffer.data( ), buffer.size( ), path );
+                close( file, path );
+            }
+
+            std::fstream file( path, std::ios::binary | std::ios::in | std::ios::out );
+            write( file, &header, 1, path );
+            close( file, path );
+        }
+
+        /// Atomically replace 'path' by the complete table at 'temp'
+        static void replace( const std::string& temp, const std::string& path ) {
+#ifdef _WIN32
+            if( !::MoveFileExA( temp.c_str( ), path.c_str( ), MOVEFILE_REPLACE_EXISTING ) )
+#else
+            if( 0 != std::rename( temp.c_str( ), path.c_str( ) ) )
+#endif
+                throw std::runtime_error( "effolkronium::mapped_guide_table: cannot replace " + path );
+        }
+
+        template<typename Stream>
+        static void close( Stream& stream, const std::string& path ) {
+            stream.close( );
+            if( !stream )
+                throw std::runtime_error( "effolkronium::mapped_guide_table: cannot write " + path );
+        }
+
+        static const double* cumulative_of( const details::mapped_file& file ) {
+            return static_cast<const double*>( static_cast<const void*>(
+                file.data( ) + sizeof( details::mapped_table_header ) ) );
+        }
+
+        template<typename Stream, typename T>
+        static void write( Stream& stream, const T* data, std::size_t count,
+                           const std::string& path ) {
+            stream.write( static_cast<const char*>( static_cast<const void*>( data ) ),
+                          static_cast<std::streamsize>( count * sizeof( T ) ) );
+            if( !stream )
+                throw std::runtime_error( "effolkronium::mapped_guide_table: cannot write " + path );
+        }
+    private:
+        details::mapped_file m_file;
+        const double* m_cumulative = nullptr;
+        const std::uint64_t* m_guide = nullptr;
+        std::size_t m_size = 0;
+        std::size_t m_last = 0;
+        std::size_t m_guide_size = 0;
+    };
+
+} // namespace effolkronium
+
+#endif // #ifndef EFFOLKRONIUM_RANDOM_MMAP_HPP
@@ -7,12 +7,18 @@
 #include <vector>
 #include <map>
 #include <unordered_map>
+#include <list>
+#include <forward_list>
+#include <set>
+#include <numeric>
 
 #ifdef _WIN32 // Unit test for case when builds fail 'cause of min\max macro included from Windows.h before random.hpp
 #include "Windows.h"
 #endif
 
 #include "current_random.hpp"
+#include "effolkronium/random_mmap.hpp"
+#include "effolkronium/random_external.hpp"
 
 TEST_CASE( "Range overflow for random integer numbers" ) {
     bool isRangeOverflow = false;
@@ -1077,3 +1083,1123 @@ TEST_CASE("Maps with non-zero total weight tests"){
     REQUIRE(Random DOT get<Random_t::weight>(nonzero_float_map) != nonzero_float_map.end());
     REQUIRE(Random DOT get<Random_t::weight>(nonzero_double_map) != nonzero_double_map.end());
 }
+
+TEST_CASE("Weighted random values from contiguous containers"){
+    std::vector<double> empty_vec;
+    std::vector<double> zero_vec = {0.0, 0.0, 0.0};
+    std::array<float, 4> arr = {{0.0f, 1.0f, 0.0f, 3.0f}};
+
+    REQUIRE(Random DOT get<Random_t::weight>(empty_vec) == empty_vec.end());
+    REQUIRE(Random DOT get<Random_t::weight>(zero_vec) == zero_vec.end());
+
+    for (int i = 0; i < 100; ++i) {
+        auto it = Random DOT get<Random_t::weight>(arr);
+        REQUIRE(it != arr.end());
+        REQUIRE(*it > 0.0f);
+    }
+
+    // Only one positive weight far behind the first blocks
+    std::vector<double> sparse(1000, 0.0);
+    sparse[777] = 0.5;
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(Random DOT get<Random_t::weight>(sparse) - sparse.begin() == 777);
+
+    std::vector<double> weights(100, 1.0);
+    std::vector<int> hits(100, 0);
+    for (int i = 0; i < 10000; ++i)
+        ++hits[static_cast<std::size_t>(Random DOT get<Random_t::weight>(weights) - weights.begin())];
+    REQUIRE(std::count(hits.begin(), hits.end(), 0) == 0);
+}
+
+TEST_CASE("Batched weighted random values"){
+    std::map<std::string, unsigned> uint_map = {{"Orange", 0u}, {"Apple", 2u}, {"Banana", 3u}};
+    std::unordered_map<std::string, double> double_umap = {{"Orange", 1.0}, {"Apple", 0.0}, {"Banana", 3.0}};
+    std::vector<float> float_vec = {0.0f, 1.0f, 0.0f, 3.0f, 0.0f};
+    std::vector<double> zero_vec = {0.0, 0.0};
+
+    std::vector<std::map<std::string, unsigned>::const_iterator> map_draws;
+    Random DOT get<Random_t::weight>(uint_map, 1000, std::back_inserter(map_draws));
+    REQUIRE(1000 == map_draws.size());
+    for (auto it : map_draws)
+        REQUIRE(it->second > 0u);
+
+    std::vector<std::unordered_map<std::string, double>::const_iterator> umap_draws(500);
+    auto umap_end = Random DOT get<Random_t::weight>(double_umap, umap_draws.size(), umap_draws.begin());
+    REQUIRE(umap_end == umap_draws.end());
+    for (auto it : umap_draws)
+        REQUIRE(it->first != "Apple");
+
+    std::vector<std::vector<float>::const_iterator> vec_draws;
+    Random DOT get<Random_t::weight>(float_vec, 4000, std::back_inserter(vec_draws));
+    REQUIRE(4000 == vec_draws.size());
+    REQUIRE(std::is_sorted(vec_draws.begin(), vec_draws.end()));
+    const auto ones = std::count(vec_draws.begin(), vec_draws.end(), float_vec.cbegin() + 1);
+    const auto threes = std::count(vec_draws.begin(), vec_draws.end(), float_vec.cbegin() + 3);
+    REQUIRE(4000 == ones + threes);
+    REQUIRE(ones > 700);
+    REQUIRE(ones < 1300);
+
+    std::vector<std::vector<double>::const_iterator> zero_draws;
+    Random DOT get<Random_t::weight>(zero_vec, 10, std::back_inserter(zero_draws));
+    REQUIRE(zero_draws.empty());
+}
+
+TEST_CASE("Guide table distribution"){
+    effolkronium::guide_table<> table{1.0, 0.0, 3.0, 0.0};
+
+    REQUIRE(4 == table.size());
+    REQUIRE(4.0 == table.total());
+    REQUIRE(0 == (table.min)());
+    REQUIRE(2 == (table.max)());
+
+    // Inversion keeps indices ordered by the uniform number
+    REQUIRE(0 == table.quantile(0.0));
+    REQUIRE(0 == table.quantile(0.2499));
+    REQUIRE(2 == table.quantile(0.25));
+    REQUIRE(2 == table.quantile(0.9999));
+
+    std::size_t previous = 0;
+    for (int i = 0; i < 1000; ++i) {
+        const auto index = table.quantile(i / 1000.0);
+        REQUIRE(index >= previous);
+        previous = index;
+    }
+
+    std::size_t counts[4] = {};
+    for (int i = 0; i < 4000; ++i)
+        ++counts[Random DOT get(table)];
+    REQUIRE(0 == counts[1]);
+    REQUIRE(0 == counts[3]);
+    REQUIRE(counts[0] > 700);
+    REQUIRE(counts[0] < 1300);
+
+    std::vector<unsigned> weights(1000, 0u);
+    weights[999] = 5u;
+    effolkronium::guide_table<float> last_only(weights.begin(), weights.end());
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(999 == Random DOT get(last_only));
+
+    // Separately rounded guide slots and thresholds never skip the answer:
+    // uniform numbers next to every guide slot boundary of skewed float tables
+    std::mt19937 weights_engine{ 1 };
+    std::size_t mismatches = 0;
+    for (int trial = 0; trial < 20; ++trial) {
+        std::vector<float> skewed(2 + weights_engine() % 5000);
+        for (auto& weight : skewed)
+            weight = 0 == weights_engine() % 4 ? 0.f
+                : std::ldexp(static_cast<float>(weights_engine() % 1000 + 1),
+                             static_cast<int>(weights_engine() % 20) - 10);
+        skewed[0] = skewed[0] > 0.f ? skewed[0] : 1.f;
+        const effolkronium::guide_table<float> table_float(skewed.begin(), skewed.end());
+        std::vector<float> cumulative(skewed.size());
+        std::partial_sum(skewed.begin(), skewed.end(), cumulative.begin());
+        for (std::size_t slot = 0; slot < skewed.size(); ++slot) {
+            const float boundary = static_cast<float>(slot) / static_cast<float>(skewed.size());
+            float u = std::nextafter(std::nextafter(boundary, 0.f), 0.f);
+            for (int step = 0; step < 5 && u < 1.f; ++step, u = std::nextafter(u, 1.f)) {
+                const auto expected = static_cast<std::size_t>(std::upper_bound(
+                    cumulative.begin(), cumulative.end(), u * cumulative.back()) - cumulative.begin());
+                if (expected < skewed.size())
+                    mismatches += expected == table_float.quantile(u) ? 0u : 1u;
+            }
+        }
+    }
+    REQUIRE(0 == mismatches);
+}
+
+TEST_CASE("Memory-mapped guide table"){
+    const std::string path = "mapped_guide_table_" + std::to_string(Random DOT get<unsigned>()) + ".bin";
+
+    const std::vector<float> weights = {1.0f, 0.0f, 3.0f, 0.0f};
+    effolkronium::mapped_guide_table::build(path, weights.begin(), weights.end());
+
+    {
+        effolkronium::mapped_guide_table table(path);
+        const effolkronium::guide_table<> in_memory(weights.begin(), weights.end());
+
+        REQUIRE(4 == table.size());
+        REQUIRE(4.0 == table.total());
+        REQUIRE(2 == (table.max)());
+
+        for (int i = 0; i < 1000; ++i)
+            REQUIRE(in_memory.quantile(i / 1000.0) == table.quantile(i / 1000.0));
+
+        effolkronium::mapped_guide_table moved = std::move(table);
+        std::size_t counts[4] = {};
+        for (int i = 0; i < 4000; ++i)
+            ++counts[Random DOT get(moved)];
+        REQUIRE(0 == counts[1]);
+        REQUIRE(0 == counts[3]);
+        REQUIRE(counts[0] > 700);
+        REQUIRE(counts[0] < 1300);
+    }
+
+    {
+        // Rebuilding doesn't touch pages of an already mapped table
+        const effolkronium::mapped_guide_table mapped(path);
+        const std::vector<double> other = {2.0, 2.0, 2.0, 2.0, 2.0};
+        effolkronium::mapped_guide_table::build(path, other.begin(), other.end());
+        REQUIRE(4.0 == mapped.total());
+        REQUIRE(10.0 == effolkronium::mapped_guide_table{path}.total());
+        effolkronium::mapped_guide_table::build(path, weights.begin(), weights.end());
+    }
+
+    // A failed rebuild leaves the previous table readable
+    const std::vector<double> zeros = {0.0, 0.0};
+    REQUIRE_THROWS_AS(effolkronium::mapped_guide_table::build(path, zeros.begin(), zeros.end()), const std::invalid_argument&);
+    {
+        const effolkronium::mapped_guide_table previous(path);
+        REQUIRE(4 == previous.size());
+        REQUIRE(4.0 == previous.total());
+    }
+    REQUIRE(nullptr == std::fopen((path + ".tmp").c_str(), "rb"));
+
+    std::ofstream(path, std::ios::trunc) << "not a table";
+    REQUIRE_THROWS_AS(effolkronium::mapped_guide_table{path}, const std::runtime_error&);
+
+    std::remove(path.c_str());
+    REQUIRE_THROWS_AS(effolkronium::mapped_guide_table{path}, const std::system_error&);
+}
+
+TEST_CASE("Weight tree distribution"){
+    effolkronium::weight_tree<> small{1.0, 0.0, 3.0};
+    REQUIRE(3 == small.size());
+    REQUIRE(4.0 == small.total());
+    REQUIRE(0 == small.quantile(0.0));
+    REQUIRE(2 == small.quantile(0.25));
+    REQUIRE(2 == small.quantile(0.9999));
+
+    // Three levels of nodes
+    effolkronium::weight_tree<> tree(5000);
+    REQUIRE(5000 == tree.size());
+    REQUIRE(0.0 == tree.total());
+
+    tree.set(4321, 2.0);
+    REQUIRE(2.0 == tree.weight(4321));
+    REQUIRE(2.0 == tree.total());
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(4321 == Random DOT get(tree));
+
+    tree.set(17, 2.0);
+    tree.set(4999, 4.0);
+    REQUIRE(8.0 == tree.total());
+    std::map<std::size_t, int> counts;
+    for (int i = 0; i < 8000; ++i)
+        ++counts[Random DOT get(tree)];
+    REQUIRE(3 == counts.size());
+    REQUIRE(counts[4999] > 3400);
+    REQUIRE(counts[4999] < 4600);
+
+    tree.set(4321, 0.0);
+    tree.set(4999, 0.0);
+    REQUIRE(2.0 == tree.total());
+    for (int i = 0; i < 100; ++i)
+        REQUIRE(17 == Random DOT get(tree));
+
+    std::vector<double> weights(300);
+    for (std::size_t i = 0; i < weights.size(); ++i)
+        weights[i] = static_cast<double>(i % 7);
+    effolkronium::weight_tree<> from_range(weights.begin(), weights.end());
+    effolkronium::guide_table<> table(weights.begin(), weights.end());
+    for (int i = 0; i < 1000; ++i)
+        REQUIRE(table.quantile(i / 1000.0) == from_range.quantile(i / 1000.0));
+}
+
+TEST_CASE("Fill existing buffers with random values"){
+    std::vector<int> vec(1000, -100);
+    Random DOT fill(vec.begin(), vec.end(), 1, 6);
+    REQUIRE(std::all_of(vec.begin(), vec.end(), [](int v) { return v >= 1 && v <= 6; }));
+    for (int v = 1; v <= 6; ++v)
+        REQUIRE(std::find(vec.begin(), vec.end(), v) != vec.end());
+
+    double buffer[300];
+    Random DOT fill(buffer, 300, 1.0, -1.0);
+    REQUIRE(std::all_of(std::begin(buffer), std::end(buffer), [](double v) { return v >= -1.0 && v <= 1.0; }));
+
+    std::array<char, 64> chars;
+    Random DOT fill(chars, 'a', 'c');
+    REQUIRE(std::all_of(chars.begin(), chars.end(), [](char v) { return v >= 'a' && v <= 'c'; }));
+
+    std::list<signed char> bytes(50);
+    Random DOT fill(bytes.begin(), bytes.end(), static_cast<signed char>(-2), static_cast<signed char>(2));
+    REQUIRE(std::all_of(bytes.begin(), bytes.end(), [](signed char v) { return v >= -2 && v <= 2; }));
+
+    std::vector<unsigned long long> same(10);
+    Random DOT fill(same, 5ull, 5ull);
+    REQUIRE(std::count(same.begin(), same.end(), 5ull) == 10);
+
+    // Reproducible from the same seed
+    std::vector<float> first(500), second(500);
+    Random DOT seed(42);
+    Random DOT fill(first, 0.f, 1.f);
+    Random DOT seed(42);
+    Random DOT fill(second.data(), second.size(), 0.f, 1.f);
+    REQUIRE(first == second);
+}
+
+TEST_CASE("Bulk bounded integer generation"){
+    static_assert(32 == effolkronium::details::engine_bits<std::mt19937>::value, "");
+    static_assert(64 == effolkronium::details::engine_bits<std::mt19937_64>::value, "");
+    static_assert(0 == effolkronium::details::engine_bits<std::minstd_rand>::value, "");
+
+    std::vector<int> ints(6000);
+    Random DOT fill(ints, 10, 15);
+    std::map<int, int> counts;
+    for (auto v : ints) ++counts[v];
+    REQUIRE(6 == counts.size());
+    REQUIRE(10 == counts.begin()->first);
+    REQUIRE(15 == counts.rbegin()->first);
+    for (auto& count : counts) {
+        REQUIRE(count.second > 800);
+        REQUIRE(count.second < 1200);
+    }
+
+    auto full = Random DOT get<std::vector>(0u, (std::numeric_limits<unsigned>::max)(), 1000);
+    REQUIRE(std::any_of(full.begin(), full.end(), [](unsigned v) { return v > 0x80000000u; }));
+
+    auto negative = Random DOT get<std::vector>(-3ll, -1ll, 1000);
+    REQUIRE(std::all_of(negative.begin(), negative.end(), [](long long v) { return v >= -3 && v <= -1; }));
+
+    auto wide = Random DOT get<std::vector>(0ull, 1ull << 40, 1000);
+    REQUIRE(std::any_of(wide.begin(), wide.end(), [](unsigned long long v) { return v > 0xFFFFFFFFull; }));
+
+    effolkronium::basic_random_local<std::mt19937_64> random64;
+    std::vector<short> shorts(999);
+    random64.fill(shorts, short{-7}, short{7});
+    REQUIRE(std::all_of(shorts.begin(), shorts.end(), [](short v) { return v >= -7 && v <= 7; }));
+    REQUIRE(std::count(shorts.begin(), shorts.end(), short{-7}) > 0);
+
+    effolkronium::basic_random_local<std::minstd_rand> minstd;
+    std::vector<unsigned> small(1000);
+    minstd.fill(small, 1u, 3u);
+    REQUIRE(std::all_of(small.begin(), small.end(), [](unsigned v) { return v >= 1u && v <= 3u; }));
+}
+
+TEST_CASE("Bulk uniform real generation"){
+    std::vector<double> doubles(10000);
+    Random DOT fill(doubles, 2.0, -2.0);
+    REQUIRE(std::all_of(doubles.begin(), doubles.end(), [](double v) { return v >= -2.0 && v <= 2.0; }));
+    const double mean = std::accumulate(doubles.begin(), doubles.end(), 0.0) / 10000;
+    REQUIRE(mean > -0.1);
+    REQUIRE(mean < 0.1);
+    REQUIRE(std::count_if(doubles.begin(), doubles.end(), [](double v) { return v < -1.0; }) > 2200);
+
+    auto floats = Random DOT get<std::vector>(10.f, 11.f, 10000);
+    REQUIRE(std::all_of(floats.begin(), floats.end(), [](float v) { return v >= 10.f && v <= 11.f; }));
+    REQUIRE(std::count_if(floats.begin(), floats.end(), [](float v) { return v > 10.5f; }) > 4500);
+
+    effolkronium::basic_random_local<std::mt19937_64> random64;
+    float small[33];
+    random64.fill(small, 33, 0.f, 0.f);
+    REQUIRE(std::all_of(std::begin(small), std::end(small), [](float v) { return v == 0.f; }));
+
+    auto long_doubles = Random DOT get<std::vector>(0.l, 1.l, 100);
+    REQUIRE(std::all_of(long_doubles.begin(), long_doubles.end(), [](long double v) { return v >= 0.l && v <= 1.l; }));
+}
+
+TEST_CASE("Random bytes"){
+    std::vector<unsigned char> buffer(4099, 0);
+    Random DOT get_bytes(buffer.data(), buffer.size());
+    std::set<unsigned char> seen(buffer.begin(), buffer.end());
+    REQUIRE(seen.size() > 200);
+    REQUIRE(std::count(buffer.begin() + 4000, buffer.end(), 0) < 20);
+
+    char chars[13] = {};
+    Random DOT fill_bytes(std::begin(chars), std::end(chars));
+
+    std::list<signed char> list(300);
+    Random DOT fill_bytes(list.begin(), list.end());
+    REQUIRE(std::set<signed char>(list.begin(), list.end()).size() > 100);
+
+    effolkronium::basic_random_local<std::mt19937_64> random64;
+    std::string str(77, '\0');
+    random64.fill_bytes(str.begin(), str.end());
+    REQUIRE(std::count(str.begin(), str.end(), '\0') < 10);
+
+    effolkronium::basic_random_local<std::minstd_rand> minstd;
+    std::array<unsigned char, 1000> arr = {{}};
+    minstd.get_bytes(arr.data(), arr.size());
+    REQUIRE(std::set<unsigned char>(arr.begin(), arr.end()).size() > 200);
+
+    // Same bytes from the same seed whatever the destination
+    std::vector<unsigned char> first(100), second(100);
+    Random DOT seed(7);
+    Random DOT get_bytes(first.data(), first.size());
+    Random DOT seed(7);
+    Random DOT fill_bytes(second.begin(), second.end());
+    REQUIRE(first == second);
+}
+
+TEST_CASE("Generate random values to output iterator"){
+    std::vector<int> vec;
+    auto inserter = Random DOT generate_n(std::back_inserter(vec), 300, 5, 1);
+    *inserter = 100;
+    REQUIRE(301 == vec.size());
+    REQUIRE(std::all_of(vec.begin(), vec.end() - 1, [](int v) { return v >= 1 && v <= 5; }));
+
+    std::ostringstream stream;
+    Random DOT generate_n(std::ostream_iterator<char>(stream), 10, 'x', 'x');
+    REQUIRE("xxxxxxxxxx" == stream.str());
+
+    double buffer[10];
+    REQUIRE(std::end(buffer) == Random DOT generate_n(std::begin(buffer), 10, 0.5, 0.75));
+    REQUIRE(std::all_of(std::begin(buffer), std::end(buffer), [](double v) { return v >= 0.5 && v <= 0.75; }));
+
+    std::list<long double> common;
+    Random DOT generate_n<Random_t::common>(std::back_inserter(common), 7, 1.f, 2.l);
+    REQUIRE(7 == common.size());
+    REQUIRE(std::all_of(common.begin(), common.end(), [](long double v) { return v >= 1.l && v <= 2.l; }));
+
+    std::vector<unsigned long> common_ints;
+    Random DOT generate_n<Random_t::common>(std::back_inserter(common_ints), 5, 1u, 3ul);
+    static_assert(std::is_same<unsigned long, decltype(common_ints)::value_type>::value, "");
+    REQUIRE(5 == common_ints.size());
+}
+
+static thread_local int allocate_count = 0;
+
+template<typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    explicit counting_allocator(int alloc_id) : id{ alloc_id } { }
+    template<typename U>
+    counting_allocator(const counting_allocator<U>& other) : id{ other.id } { }
+
+    T* allocate(std::size_t n) {
+        ++allocate_count;
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template<typename U>
+    bool operator==(const counting_allocator<U>& other) const { return id == other.id; }
+    template<typename U>
+    bool operator!=(const counting_allocator<U>& other) const { return id != other.id; }
+
+    int id;
+};
+
+template<typename T>
+using counting_vector = std::vector<T, counting_allocator<T>>;
+
+template<typename T>
+using counting_list = std::list<T, counting_allocator<T>>;
+
+TEST_CASE("Allocator-aware random containers"){
+    allocate_count = 0;
+    auto vec = Random DOT get<counting_vector>(1, 6, 1000, counting_allocator<int>{ 42 });
+    static_assert(std::is_same<int, decltype(vec)::value_type>::value, "");
+    REQUIRE(1000 == vec.size());
+    REQUIRE(42 == vec.get_allocator().id);
+    REQUIRE(1 == allocate_count);
+    REQUIRE(std::all_of(vec.begin(), vec.end(), [](int v) { return v >= 1 && v <= 6; }));
+
+    auto list = Random DOT get<counting_list>(0.25, 0.5, 10, counting_allocator<double>{ 7 });
+    REQUIRE(10 == list.size());
+    REQUIRE(7 == list.get_allocator().id);
+    REQUIRE(std::all_of(list.begin(), list.end(), [](double v) { return v >= 0.25 && v <= 0.5; }));
+
+    auto common = Random DOT get<counting_vector, Random_t::common>(1u, 3ul, 5,
+        counting_allocator<unsigned long>{ 3 });
+    static_assert(std::is_same<unsigned long, decltype(common)::value_type>::value, "");
+    REQUIRE(5 == common.size());
+    REQUIRE(3 == common.get_allocator().id);
+
+    auto plain = Random DOT get<std::vector>('a', 'z', 20, std::allocator<char>{ });
+    REQUIRE(20 == plain.size());
+    REQUIRE(std::all_of(plain.begin(), plain.end(), [](char v) { return v >= 'a' && v <= 'z'; }));
+}
+
+#ifdef RANDOM_LOCAL
+TEST_CASE("Parallel fill is independent of thread count"){
+    const std::size_t size = 300007; // several chunks and a partial one
+    std::vector<std::vector<int>> results;
+    std::vector<std::vector<double>> real_results;
+
+    for (std::size_t threads : { 1u, 3u, 8u, 0u }) {
+        Random_t random;
+        random.seed(42);
+        std::vector<int> values(size);
+        random.parallel_fill(values.begin(), values.end(), -50, 50, threads);
+        std::vector<double> reals(size);
+        random.parallel_fill(reals.data(), reals.data() + size, 1.0, 2.0, threads);
+
+        Random_t::engine_type engine{ 42 };
+        engine.discard(8);
+        REQUIRE(random.is_equal(engine));
+
+        REQUIRE(std::all_of(values.begin(), values.end(), [](int v) { return v >= -50 && v <= 50; }));
+        REQUIRE(std::all_of(reals.begin(), reals.end(), [](double v) { return v >= 1.0 && v < 2.0; }));
+        results.push_back(std::move(values));
+        real_results.push_back(std::move(reals));
+    }
+
+    for (std::size_t i = 1; i < results.size(); ++i) {
+        REQUIRE(results[0] == results[i]);
+        REQUIRE(real_results[0] == real_results[i]);
+    }
+    // Chunks are drawn from different substreams
+    REQUIRE(!std::equal(results[0].begin(), results[0].begin() + 100, results[0].begin() + (1 << 16)));
+
+    std::vector<int> empty;
+    Random_t random;
+    random.parallel_fill(empty.begin(), empty.end(), 1, 2, 4);
+    REQUIRE(empty.empty());
+}
+#endif
+
+TEST_CASE("Parallel for rethrows exceptions of workers"){
+    REQUIRE_THROWS_AS(effolkronium::details::parallel_for(1000, 4, [](std::size_t i) {
+        if (10 == i) throw std::runtime_error("failed");
+    }), const std::runtime_error&);
+
+    // Only threads other than the calling one throw
+    const std::thread::id caller = std::this_thread::get_id();
+    REQUIRE_THROWS_AS(effolkronium::details::parallel_for(64, 4, [&](std::size_t) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (caller != std::this_thread::get_id()) throw std::length_error("worker");
+    }), const std::length_error&);
+}
+
+TEST_CASE("Lazy random value views"){
+    auto sized = Random DOT view(1, 6, 300);
+    static_assert(std::is_same<int, decltype(sized)::value_type>::value, "");
+    std::size_t count = 0;
+    for (int value : sized) {
+        REQUIRE(value >= 1);
+        REQUIRE(value <= 6);
+        ++count;
+    }
+    REQUIRE(300 == count);
+    REQUIRE(sized.begin() == sized.end());
+
+    auto infinite = Random DOT view<double>(0.5, 0.75);
+    std::vector<double> taken;
+    auto it = infinite.begin();
+    for (std::size_t i = 0; i < 1000; ++i, ++it) {
+        REQUIRE(it != infinite.end());
+        taken.push_back(*it);
+    }
+    REQUIRE(std::all_of(taken.begin(), taken.end(), [](double v) { return v >= 0.5 && v <= 0.75; }));
+    REQUIRE(taken.front() != taken.back());
+
+    auto chars = Random DOT view('a', 'c', 3);
+    auto chars_it = chars.begin();
+    const char first = *chars_it++;
+    REQUIRE(first >= 'a');
+    REQUIRE(first <= 'c');
+    REQUIRE(2 == std::distance(chars_it, chars.end()));
+
+    auto empty = Random DOT view(1, 2, 0);
+    REQUIRE(empty.begin() == empty.end());
+}
+
+TEST_CASE("Fill with normally distributed values"){
+    std::vector<double> values(100001);
+    Random DOT fill_normal(values.begin(), values.end(), 5.0, 2.0);
+    const double mean = std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+    double variance = 0.0;
+    for (double v : values)
+        variance += (v - mean) * (v - mean);
+    variance /= static_cast<double>(values.size());
+    REQUIRE(std::abs(mean - 5.0) < 0.05);
+    REQUIRE(std::abs(variance - 4.0) < 0.1);
+    REQUIRE(std::all_of(values.begin(), values.end(), [](double v) { return std::isfinite(v); }));
+
+    float weights[333];
+    Random DOT fill_normal(weights, 0.f, 0.01f);
+    REQUIRE(std::all_of(std::begin(weights), std::end(weights), [](float v) { return std::abs(v) < 0.1f; }));
+    REQUIRE(weights[0] != weights[1]);
+
+    std::list<long double> noise(7);
+    Random DOT fill_normal(noise.begin(), noise.end(), 1.l, 0.5l);
+    REQUIRE(std::all_of(noise.begin(), noise.end(), [](long double v) { return std::isfinite(v); }));
+}
+
+template<typename T, std::size_t N>
+struct IndexOnlyArray {
+    T& operator[](std::size_t i) { return values[i]; }
+    T values[N];
+};
+
+TEST_CASE("Fixed-size array generation"){
+    auto vec4 = Random DOT get<std::array, 4>(-1.f, 1.f);
+    static_assert(std::is_same<std::array<float, 4>, decltype(vec4)>::value, "");
+    REQUIRE(std::all_of(vec4.begin(), vec4.end(), [](float v) { return v >= -1.f && v <= 1.f; }));
+
+    auto ints = Random DOT get<std::array, 300>(5, 10);
+    REQUIRE(std::all_of(ints.begin(), ints.end(), [](int v) { return v >= 5 && v <= 10; }));
+
+    auto none = Random DOT get<std::array, 0>(1, 2);
+    REQUIRE(none.empty());
+
+    auto indexed = Random DOT get<IndexOnlyArray, 3>('x', 'z');
+    REQUIRE(std::all_of(std::begin(indexed.values), std::end(indexed.values), [](char v) { return v >= 'x' && v <= 'z'; }));
+
+    auto common = Random DOT get<IndexOnlyArray, 5, Random_t::common>(1u, 3ul);
+    static_assert(std::is_same<IndexOnlyArray<unsigned long, 5>, decltype(common)>::value, "");
+    REQUIRE(std::all_of(std::begin(common.values), std::end(common.values), [](unsigned long v) { return v >= 1 && v <= 3; }));
+}
+
+TEST_CASE("Parallel shuffle"){
+    const int size = 300007; // several blocks of different sizes
+    std::vector<std::vector<int>> results;
+    for (std::size_t threads : { 1u, 3u, 0u }) {
+        Random DOT seed(7);
+        std::vector<int> values(size);
+        std::iota(values.begin(), values.end(), 0);
+        Random DOT parallel_shuffle(values, threads);
+
+        Random_t::engine_type engine{ 7 };
+        engine.discard(4);
+        REQUIRE(Random DOT is_equal(engine));
+
+        std::vector<int> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<int> expected(size);
+        std::iota(expected.begin(), expected.end(), 0);
+        REQUIRE(expected == sorted);
+        results.push_back(std::move(values));
+    }
+    for (std::size_t i = 1; i < results.size(); ++i)
+        REQUIRE(results[0] == results[i]);
+
+    // Elements leave their blocks
+    std::size_t moved_far = 0;
+    for (std::size_t i = 0; i < results[0].size(); ++i)
+        if (std::abs(results[0][i] - static_cast<int>(i)) > (1 << 16))
+            ++moved_far;
+    REQUIRE(moved_far > results[0].size() / 2);
+
+    // Every permutation of a small range appears with equal probability
+    std::map<std::array<int, 3>, int> counts;
+    for (int i = 0; i < 6000; ++i) {
+        std::array<int, 3> small = {{ 0, 1, 2 }};
+        Random DOT parallel_shuffle(small.begin(), small.end(), 2);
+        ++counts[small];
+    }
+    REQUIRE(6 == counts.size());
+    for (const auto& count : counts)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+
+    // Merging two shuffled halves gives every permutation with equal probability
+    std::map<std::array<int, 4>, int> merged;
+    std::mt19937 engine;
+    for (int i = 0; i < 24000; ++i) {
+        std::array<int, 4> small = {{ 0, 1, 2, 3 }};
+        std::shuffle(small.begin(), small.begin() + 1, engine);
+        std::shuffle(small.begin() + 1, small.end(), engine);
+        effolkronium::details::merge_shuffled(small.begin(), small.begin() + 1, small.end(), engine);
+        ++merged[small];
+    }
+    REQUIRE(24 == merged.size());
+    for (const auto& count : merged)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+}
+
+TEST_CASE("Bucketed shuffle"){
+    std::vector<int> values(1000003); // several buckets
+    std::iota(values.begin(), values.end(), 0);
+    Random DOT shuffle<Random_t::bucketed>(values);
+
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> expected(values.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(expected == sorted);
+    REQUIRE(expected != values);
+
+    // Elements leave their neighbourhood
+    std::size_t moved_far = 0;
+    for (std::size_t i = 0; i < values.size(); ++i)
+        if (std::abs(values[i] - static_cast<int>(i)) > 100000)
+            ++moved_far;
+    REQUIRE(moved_far > values.size() / 2);
+
+    std::vector<std::string> strings(100000, "abc");
+    strings[5] = "def";
+    Random DOT shuffle<Random_t::bucketed>(strings.begin(), strings.end());
+    REQUIRE(1 == std::count(strings.begin(), strings.end(), "def"));
+    REQUIRE(99999 == std::count(strings.begin(), strings.end(), "abc"));
+
+    // Small ranges are shuffled uniformly as well
+    std::map<std::array<int, 3>, int> counts;
+    for (int i = 0; i < 6000; ++i) {
+        std::array<int, 3> small = {{ 0, 1, 2 }};
+        Random DOT shuffle<Random_t::bucketed>(small);
+        ++counts[small];
+    }
+    REQUIRE(6 == counts.size());
+    for (const auto& count : counts)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+}
+
+template<typename Engine, std::size_t N>
+void check_uniform_shuffle(Engine& engine) {
+    std::map<std::array<int, N>, int> counts;
+    std::array<int, N> values;
+    std::iota(values.begin(), values.end(), 0);
+    int permutations = 1;
+    for (int i = 2; i <= static_cast<int>(N); ++i)
+        permutations *= i;
+    for (int i = 0; i < permutations * 1000; ++i) {
+        effolkronium::details::shuffle(values.begin(), values.end(), engine);
+        ++counts[values];
+    }
+    REQUIRE(static_cast<std::size_t>(permutations) == counts.size());
+    for (const auto& count : counts)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+}
+
+TEST_CASE("Batched Fisher-Yates shuffle"){
+    std::uint64_t low = 0;
+    REQUIRE(0u == effolkronium::details::multiply_high(3, 5, low));
+    REQUIRE(15u == low);
+    REQUIRE(0xFFFFFFFFFFFFFFFEull == effolkronium::details::multiply_high(
+        0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFFFFFFFFFFull, low));
+    REQUIRE(1u == low);
+
+    std::uint64_t indices[6];
+    std::mt19937_64 engine64;
+    for (int i = 0; i < 1000; ++i) {
+        effolkronium::details::batched_indices(engine64, 10, 6, indices);
+        for (std::uint64_t j = 0; j < 6; ++j)
+            REQUIRE(indices[j] < 10 - j);
+    }
+
+    std::mt19937 engine32;
+    std::minstd_rand engine_other;
+    check_uniform_shuffle<std::mt19937_64, 3>(engine64);
+    check_uniform_shuffle<std::mt19937, 4>(engine32);
+    check_uniform_shuffle<std::minstd_rand, 3>(engine_other);
+
+    std::vector<int> values(100000);
+    std::iota(values.begin(), values.end(), 0);
+    Random DOT shuffle(values);
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> expected(values.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    REQUIRE(expected == sorted);
+    REQUIRE(expected != values);
+
+    std::vector<int> empty;
+    Random DOT shuffle(empty);
+    std::vector<int> single{ 5 };
+    Random DOT shuffle(single);
+    REQUIRE(5 == single[0]);
+}
+
+TEST_CASE("Partial shuffle and sample"){
+    std::vector<int> values(1000000);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto middle = Random DOT partial_shuffle(values, 10);
+    REQUIRE(values.begin() + 10 == middle);
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    REQUIRE(std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end());
+    REQUIRE(0 == sorted.front());
+    REQUIRE(999999 == sorted.back());
+
+    std::vector<int> picked;
+    const std::vector<int> source = sorted;
+    Random DOT sample(source.begin(), source.end(), 20, std::back_inserter(picked));
+    REQUIRE(20 == picked.size());
+    std::set<int> unique(picked.begin(), picked.end());
+    REQUIRE(20 == unique.size());
+
+    picked.clear();
+    Random DOT sample(source.begin(), source.begin() + 5, 10, std::back_inserter(picked));
+    std::sort(picked.begin(), picked.end());
+    REQUIRE((std::vector<int>{ 0, 1, 2, 3, 4 }) == picked);
+
+    std::array<int, 4> small = {{ 0, 1, 2, 3 }};
+    REQUIRE(small.begin() == Random DOT partial_shuffle(small.begin(), small.end(), 0));
+    REQUIRE(small.end() == Random DOT partial_shuffle(small.begin(), small.end(), 100));
+
+    // Every ordered pair of 4 elements appears with equal probability
+    std::map<std::pair<int, int>, int> shuffled, sampled;
+    for (int i = 0; i < 12000; ++i) {
+        std::array<int, 4> arr = {{ 0, 1, 2, 3 }};
+        Random DOT partial_shuffle(arr, 2);
+        ++shuffled[std::make_pair(arr[0], arr[1])];
+
+        int out[2];
+        Random DOT sample(arr.begin(), arr.end(), 2, out);
+        ++sampled[std::make_pair(out[0], out[1])];
+    }
+    REQUIRE(12 == shuffled.size());
+    REQUIRE(12 == sampled.size());
+    for (const auto& count : shuffled)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+    for (const auto& count : sampled)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+}
+
+TEST_CASE("Distinct random integers"){
+    auto ids = Random DOT get_unique<std::vector>(0ull, (1ull << 40) - 1, 1000);
+    static_assert(std::is_same<unsigned long long, decltype(ids)::value_type>::value, "");
+    REQUIRE(1000 == ids.size());
+    REQUIRE(1000 == std::set<unsigned long long>(ids.begin(), ids.end()).size());
+    REQUIRE(std::all_of(ids.begin(), ids.end(), [](unsigned long long v) { return v < (1ull << 40); }));
+
+    auto all = Random DOT get_unique<std::set>(5, -4, 10);
+    REQUIRE(10 == all.size());
+    REQUIRE(-4 == *all.begin());
+    REQUIRE(5 == *all.rbegin());
+
+    auto extreme = Random DOT get_unique<std::vector>(
+        (std::numeric_limits<long long>::min)(), (std::numeric_limits<long long>::max)(), 100);
+    REQUIRE(100 == std::set<long long>(extreme.begin(), extreme.end()).size());
+
+    auto shorts = Random DOT get_unique<std::list>(short(-3), short(3), 7);
+    REQUIRE(7 == std::set<short>(shorts.begin(), shorts.end()).size());
+
+    REQUIRE(Random DOT get_unique<std::vector>(1, 100, 0).empty());
+    REQUIRE_THROWS_AS(Random DOT get_unique<std::vector>(1, 100, 101), const std::invalid_argument&);
+    REQUIRE_THROWS_AS(Random DOT get_unique<std::set>(short(7), short(7), 2), const std::invalid_argument&);
+
+    // Every 2-subset of 4 values appears with equal probability
+    std::map<std::set<int>, int> counts;
+    for (int i = 0; i < 6000; ++i) {
+        auto pair = Random DOT get_unique<std::set>(0, 3, 2);
+        ++counts[pair];
+    }
+    REQUIRE(6 == counts.size());
+    for (const auto& count : counts)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+
+    // The order is uniform too: any position holds any value equally likely
+    std::map<int, int> firsts;
+    for (int i = 0; i < 10000; ++i)
+        ++firsts[Random DOT get_unique<std::vector>(0, 9, 2)[0]];
+    REQUIRE(10 == firsts.size());
+    for (const auto& count : firsts)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+}
+
+namespace {
+    /// Forward iterator over std::forward_list which counts its increments
+    struct counted_iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int*;
+        using reference = const int&;
+
+        std::forward_list<int>::const_iterator it;
+        std::size_t* steps;
+
+        reference operator*() const { return *it; }
+        counted_iterator& operator++() { ++it; ++*steps; return *this; }
+        counted_iterator operator++(int) { counted_iterator previous = *this; ++*this; return previous; }
+        bool operator==(const counted_iterator& other) const { return it == other.it; }
+        bool operator!=(const counted_iterator& other) const { return it != other.it; }
+    };
+}
+
+TEST_CASE("Reservoir selection from single-pass ranges"){
+    std::list<int> list = { 0, 1, 2, 3 };
+    std::map<int, int> counts;
+    for (int i = 0; i < 4000; ++i)
+        ++counts[*Random DOT get(list.begin(), list.end())];
+    REQUIRE(4 == counts.size());
+    for (const auto& count : counts)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+
+    std::list<int> empty;
+    REQUIRE(empty.end() == Random DOT get(empty));
+
+    std::set<int> set = { 5 };
+    REQUIRE(5 == *Random DOT get(set));
+
+    // Forward ranges are traversed once, not measured first
+    const std::forward_list<int> forward(1000, 1);
+    std::size_t steps = 0;
+    for (int i = 0; i < 100; ++i)
+        Random DOT get(counted_iterator{ forward.begin(), &steps }, counted_iterator{ forward.end(), &steps });
+    REQUIRE(100 * 1000 == steps);
+
+    std::istringstream single("9");
+    REQUIRE(9 == *Random DOT get(std::istream_iterator<int>(single), std::istream_iterator<int>()));
+
+    // Every ordered pair of 4 elements appears with equal probability
+    std::map<std::pair<int, int>, int> pairs;
+    for (int i = 0; i < 12000; ++i) {
+        std::istringstream stream("0 1 2 3");
+        int out[2];
+        REQUIRE(out + 2 == Random DOT sample(std::istream_iterator<int>(stream),
+                                             std::istream_iterator<int>(), 2, out));
+        ++pairs[std::make_pair(out[0], out[1])];
+    }
+    REQUIRE(12 == pairs.size());
+    for (const auto& count : pairs)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+
+    // Long streams are skipped through in one pass
+    std::vector<int> numbers(1000000);
+    std::iota(numbers.begin(), numbers.end(), 0);
+    std::list<int> long_list(numbers.begin(), numbers.end());
+    auto selected = Random DOT sample(long_list.begin(), long_list.end(), 100);
+    static_assert(std::is_same<std::vector<int>, decltype(selected)>::value, "");
+    REQUIRE(100 == std::set<int>(selected.begin(), selected.end()).size());
+    REQUIRE(std::count_if(selected.begin(), selected.end(), [](int v) { return v >= 500000; }) > 25);
+
+    auto from_vector = Random DOT sample(numbers.begin(), numbers.end(), 10);
+    REQUIRE(10 == std::set<int>(from_vector.begin(), from_vector.end()).size());
+
+    std::istringstream short_stream("7 8");
+    auto all = Random DOT sample(std::istream_iterator<int>(short_stream), std::istream_iterator<int>(), 5);
+    std::sort(all.begin(), all.end());
+    REQUIRE((std::vector<int>{ 7, 8 }) == all);
+}
+
+TEST_CASE("Random permutation"){
+    for (std::uint64_t size : { 1u, 2u, 3u, 10u, 1000u, 4097u }) {
+        auto permutation = Random DOT permutation(size);
+        REQUIRE(size == permutation.size());
+        std::vector<std::uint64_t> values(permutation.begin(), permutation.end());
+        std::sort(values.begin(), values.end());
+        for (std::uint64_t i = 0; i < size; ++i)
+            if (i != values[static_cast<std::size_t>(i)])
+                FAIL("not a permutation");
+    }
+
+    const effolkronium::random_permutation keyed(1000000, 42);
+    REQUIRE(Random DOT permutation(1000000, 42)[123456] == keyed[123456]);
+    const effolkronium::random_permutation other(1000000, 43);
+    REQUIRE(false == std::equal(keyed.begin(), keyed.end(), other.begin()));
+
+    const effolkronium::random_permutation huge(10000000000ull, 7);
+    std::set<std::uint64_t> visited;
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        REQUIRE(huge[i] < 10000000000ull);
+        visited.insert(huge[i]);
+    }
+    REQUIRE(1000 == visited.size());
+
+    const effolkronium::random_permutation full((std::numeric_limits<std::uint64_t>::max)(), 1);
+    REQUIRE(full[0] != full[1]);
+
+    const effolkronium::random_permutation empty(0, 1);
+    REQUIRE(empty.begin() == empty.end());
+
+    // Every value is equally likely in the first position over random keys
+    std::map<std::uint64_t, int> counts;
+    for (int i = 0; i < 5000; ++i)
+        ++counts[Random DOT permutation(5)[0]];
+    REQUIRE(5 == counts.size());
+    for (const auto& count : counts)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+}
+
+namespace {
+    std::string make_records(std::uint64_t count) {
+        std::string records;
+        for (std::uint64_t i = 0; i < count; ++i)
+            records.append(reinterpret_cast<const char*>(&i), sizeof i);
+        return records;
+    }
+
+    std::vector<std::uint64_t> read_records(const std::string& records) {
+        std::vector<std::uint64_t> values(records.size() / sizeof(std::uint64_t));
+        std::memcpy(values.data(), records.data(), records.size());
+        return values;
+    }
+}
+
+TEST_CASE("Out-of-core shuffle and sampling"){
+    const std::string records = make_records(10000);
+
+    std::mt19937 engine{ 42 };
+    std::istringstream in(records);
+    std::ostringstream out;
+    effolkronium::external_shuffle(in, out, 8, engine, 4096, 4); // several levels of spill files
+    auto shuffled = read_records(out.str());
+    REQUIRE(10000 == shuffled.size());
+    REQUIRE(read_records(records) != shuffled);
+    std::sort(shuffled.begin(), shuffled.end());
+    REQUIRE(read_records(records) == shuffled);
+
+    std::mt19937 same_engine{ 42 };
+    std::ostringstream region_out;
+    effolkronium::external_shuffle(records.data(), records.size(), region_out, 8, same_engine, 4096, 4);
+    REQUIRE(out.str() == region_out.str());
+
+    std::ostringstream in_memory;
+    std::istringstream small_in(records);
+    effolkronium::external_shuffle(small_in, in_memory, 8, engine);
+    REQUIRE(records.size() == in_memory.str().size());
+
+    // Every permutation appears with equal probability through spill files
+    std::map<std::string, int> counts;
+    for (int i = 0; i < 6000; ++i) {
+        std::istringstream abc("abc");
+        std::ostringstream permuted;
+        effolkronium::external_shuffle(abc, permuted, 1, engine, 1, 2);
+        ++counts[permuted.str()];
+    }
+    REQUIRE(6 == counts.size());
+    for (const auto& count : counts)
+        REQUIRE(std::abs(count.second - 1000) < 200);
+
+    std::istringstream sample_in(records);
+    auto sampled = effolkronium::sample_records(sample_in, 8, 100, engine);
+    REQUIRE(100 == sampled.size());
+    REQUIRE(100 == std::set<std::string>(sampled.begin(), sampled.end()).size());
+
+    std::map<char, int> weighted;
+    for (int i = 0; i < 10000; ++i) {
+        std::istringstream weighted_in(std::string("\x01\x02\x03\x04\x00", 5));
+        auto picked = effolkronium::weighted_sample_records(weighted_in, 1, 1, engine,
+            [](const std::string& record) { return static_cast<double>(record[0]); });
+        REQUIRE(1 == picked.size());
+        ++weighted[picked[0][0]];
+    }
+    REQUIRE(4 == weighted.size());
+    for (const auto& count : weighted)
+        REQUIRE(std::abs(count.second - 1000 * count.first) < 200);
+
+    std::istringstream pairs_in(std::string("\x01\x05", 2));
+    auto both = effolkronium::weighted_sample_records(pairs_in, 1, 5, engine,
+        [](const std::string& record) { return static_cast<double>(record[0]); });
+    REQUIRE(2 == both.size());
+
+    // The order depends only on the engine output, on every standard library
+    std::string bytes;
+    for (char i = 0; i < 40; ++i)
+        bytes.push_back(i);
+    std::mt19937 pinned{ 42 };
+    std::istringstream bytes_in(bytes);
+    std::ostringstream bytes_out;
+    effolkronium::external_shuffle(bytes_in, bytes_out, 1, pinned, 8, 3);
+    const char expected[] = { 6, 4, 37, 21, 13, 15, 5, 14, 32, 16, 19, 22, 36, 10, 29, 31, 26, 3, 18, 23,
+                              27, 39, 20, 17, 0, 28, 30, 8, 24, 35, 33, 38, 7, 11, 34, 25, 9, 12, 1, 2 };
+    REQUIRE(std::string(expected, sizeof expected) == bytes_out.str());
+
+    std::istringstream truncated("abc");
+    std::ostringstream ignored;
+    REQUIRE_THROWS_AS(effolkronium::external_shuffle(truncated, ignored, 2, engine),
+                      const std::runtime_error&);
+    REQUIRE_THROWS_AS(effolkronium::external_shuffle(truncated, ignored, 0, engine),
+                      const std::invalid_argument&);
+    std::istringstream few(make_records(8));
+    REQUIRE_THROWS_AS(effolkronium::external_shuffle(few, ignored, 8, engine, 16, 1),
+                      const std::invalid_argument&);
+    REQUIRE_THROWS_AS(effolkronium::external_shuffle(records.data(), records.size(), ignored, 8, engine, 16, 1),
+                      const std::invalid_argument&);
+}
+
+TEST_CASE("Random bitset"){
+    const auto popcount = [](const std::vector<std::uint64_t>& words) {
+        std::size_t count = 0;
+        for (std::uint64_t word : words)
+            for (; 0 != word; word &= word - 1)
+                ++count;
+        return count;
+    };
+
+    for (double p : { 0.01, 0.3, 0.5, 0.99 }) {
+        const auto bits = Random DOT random_bitset(1000000, p);
+        REQUIRE(15625 == bits.size());
+        const double expected = p * 1000000;
+        REQUIRE(std::abs(static_cast<double>(popcount(bits)) - expected) < 2000);
+    }
+
+    REQUIRE(0 == popcount(Random DOT random_bitset(1000, 0.)));
+    REQUIRE(1000 == popcount(Random DOT random_bitset(1000, 1.)));
+    REQUIRE(Random DOT random_bitset(0, 0.5).empty());
+
+#ifdef RANDOM_LOCAL
+    // Tiny probabilities are skipped through, not rounded to zero
+    Random_t random;
+    const Random_t::engine_type before = random.engine();
+    REQUIRE(0 == popcount(random.random_bitset(1000, 1e-12)));
+    REQUIRE(false == random.is_equal(before));
+    const Random_t::engine_type after = random.engine();
+    random.random_bitset(1000, 0.);
+    REQUIRE(random.is_equal(after));
+#endif
+
+    // Bits past nbits are cleared whatever the probability
+    for (double p : { 0.01, 0.5, 0.99, 1. }) {
+        std::vector<std::uint64_t> words(3, ~std::uint64_t{ 0 });
+        Random DOT fill_bernoulli_bits(words.data(), 130, p);
+        REQUIRE(0 == (words[2] >> 2));
+    }
+
+    // Every position is equally likely to be set
+    std::vector<int> counts(100);
+    for (int i = 0; i < 10000; ++i) {
+        const auto bits = Random DOT random_bitset(100, 0.05);
+        for (std::size_t bit = 0; bit < 100; ++bit)
+            counts[bit] += static_cast<int>(bits[bit / 64] >> (bit % 64) & 1u);
+    }
+    for (int count : counts)
+        REQUIRE(std::abs(count - 500) < 120);
+}
+
+namespace {
+    /// Return true if 'value' is in [index / size; (index + 1) / size), checked exactly
+    template<typename T>
+    bool in_stratum(T value, std::size_t index, std::size_t size) {
+        const double lower = static_cast<double>(index), count = static_cast<double>(size);
+        return std::fma(static_cast<double>(value), count, -lower) >= 0
+            && std::fma(static_cast<double>(value), count, -(lower + 1)) < 0;
+    }
+}
+
+TEST_CASE("Stratified and Latin hypercube sampling"){
+    std::vector<double> values(1000);
+    REQUIRE(values.end() == Random DOT stratified_uniform(values.size(), values.begin()));
+    for (std::size_t i = 0; i < values.size(); ++i)
+        REQUIRE(in_stratum(values[i], i, values.size()));
+
+    // Float strata stay exact where offsets inside them are a few ulps wide
+    std::vector<float> floats(100000);
+    Random DOT stratified_uniform(floats.size(), floats.data());
+    std::size_t outside = 0;
+    for (std::size_t i = 0; i < floats.size(); ++i)
+        outside += in_stratum(floats[i], i, floats.size()) ? 0u : 1u;
+    REQUIRE(0 == outside);
+
+    std::vector<float> single(1);
+    Random DOT stratified_uniform(1, single.begin());
+    REQUIRE(single[0] >= 0.f);
+    REQUIRE(single[0] < 1.f);
+
+    const auto check_design = [](const std::vector<float>& design, std::size_t size, std::size_t dims) {
+        for (std::size_t d = 0; d < dims; ++d) {
+            // Every stratum of every dimension holds exactly one point
+            std::vector<int> strata(size);
+            for (std::size_t i = 0; i < size; ++i) {
+                const float value = design[d * size + i];
+                REQUIRE(value >= 0.f);
+                REQUIRE(value < 1.f);
+                const auto stratum = static_cast<std::size_t>(static_cast<double>(value) * static_cast<double>(size));
+                REQUIRE(in_stratum(value, stratum, size));
+                ++strata[stratum];
+            }
+            REQUIRE(std::vector<int>(size, 1) == strata);
+        }
+    };
+
+    const std::size_t size = 500, dims = 4;
+    std::vector<float> design(size * dims);
+    REQUIRE(design.data() + size * dims == Random DOT latin_hypercube(size, dims, design.data()));
+    check_design(design, size, dims);
+    // Dimensions are shuffled independently
+    REQUIRE(false == std::equal(design.begin(), design.begin() + size, design.begin() + size));
+    REQUIRE(false == std::is_sorted(design.begin(), design.begin() + size));
+
+    std::vector<float> large(100000);
+    Random DOT latin_hypercube(large.size(), 1, large.begin());
+    check_design(large, large.size(), 1);
+
+    REQUIRE(design.begin() == Random DOT latin_hypercube(0, dims, design.begin()));
+}